@@ -0,0 +1,67 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstdint>
+
+// Bit tricks on 64-bit masks. They are written so that any compiler turns
+// them into a few straight-line instructions; no CPU extension is assumed.
+
+inline
+int popCount(uint64_t x)
+{
+   x = x - ((x >> 1) & 0x5555555555555555ULL);
+   x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+   x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+   return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+// The position of the n-th (from 0) set bit of x, which must have more than n
+// set bits. The byte holding it is found from the per-byte counts, then the
+// bit inside that byte; at most 8 + 8 cheap steps whatever x is.
+inline
+int selectBit(uint64_t x, int n)
+{
+   auto bytes = x - ((x >> 1) & 0x5555555555555555ULL);
+   bytes = (bytes & 0x3333333333333333ULL) + ((bytes >> 2) & 0x3333333333333333ULL);
+   bytes = (bytes + (bytes >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+   auto shift = 0;
+   for (auto cnt = static_cast<int>(bytes & 0xFF); cnt <= n; cnt = static_cast<int>((bytes >> shift) & 0xFF)) {
+      n -= cnt;
+      shift += 8;
+   }
+
+   auto byte = static_cast<unsigned>((x >> shift) & 0xFF);
+   for (; n > 0; --n) {
+      byte &= byte - 1; // drops the lowest set bit
+   }
+   auto bit = 0;
+   for (; (byte & 1u) == 0; byte >>= 1) {
+      ++bit;
+   }
+   return shift + bit;
+}
@@ -0,0 +1,238 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "GameObserver.h"
+#include "GameRules.h"
+#include "KeyboardLayout.h"
+#include "KeyboardModel.h"
+#include "KeyStats.h"
+#include "ToonPool.h"
+
+#include "cinder/Rect.h"
+#include "cinder/Rand.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The rules of a game (spawning, scoring, streaks, time penalties and the
+// toons) without any window, GPU or audio device. It advances in fixed steps
+// of TIME_STEP seconds; what it decides is reported to its observers. All of
+// its randomness comes from its own generator, so a seed, the layout and the
+// keys pressed at each step are enough to play a game again.
+//
+// The reaction time and error rate of each key are kept in game time as the
+// game goes; an adaptive game weights the keyboard with them, so the keys
+// the student struggles with are drawn more often.
+class GameCore {
+   public:
+      struct StreakBonus {
+         std::string bonus;
+         ci::vec2 pos;
+         double expiration;
+      };
+
+      enum class State{ Preset, Playing, GameOver };
+
+      using KeyToonPair = std::pair<int, ToonPool::Handle>;
+      using VKeyToon = std::vector<KeyToonPair>;
+      using VStreakBonus = std::vector<StreakBonus>;
+
+      static const double TIME_STEP;
+      static const double STREAK_BONUS_EXPIRATION;
+
+      GameCore(const GameRules& rules, const KeyboardLayout& layout, uint32_t seed);
+
+      static void pruneStreakBonuses(VStreakBonus* pBonuses, double time);
+
+      void addToon(const ci::vec2& size);
+      void addObserver(GameObserver* pObserver);
+      void setBounds(const ci::Rectf& bounds);
+      void step();
+      void keyDown(int code);
+
+      KeyboardModel& getKeyboard();
+      const KeyboardModel& getKeyboard() const;
+      const KeyStats& getKeyStats() const;
+      State getState() const;
+      const GameRules& getRules() const;
+      uint32_t getSeed() const;
+      uint32_t getStepCount() const;
+      const ci::Rectf& getBounds() const;
+      const ToonPool& getToons() const;
+      double getTime() const;
+      double getDuration() const;
+      double getScore() const;
+      int getStreakCnt() const;
+      int getStreakThreshold() const;
+      bool isPerfectGame() const;
+      const VKeyToon& getKeyToonPairs() const;
+      const VStreakBonus& getStreakBonuses() const;
+      double computeFillRatio(double time) const;
+
+   private:
+      using VObserver = std::vector<GameObserver*>;
+      using VHandle = std::vector<ToonPool::Handle>;
+
+      void stepToons(bool hurledOnlyFlag);
+      void updateNextSpawingTime();
+      int randSelectToon();
+      void incStreakCount(int keyCode);
+      void resetStreakCount();
+      void updateKeyWeight(int keyCode, int slot);
+      void newStreakBonus(double bonus, ci::vec2 pos);
+
+      State mState{ State::Preset };
+      bool mPerfectGameBonusOnceFlag{ true };
+      bool mPerfectGameFlag{ true };
+      GameRules mRules;
+      uint32_t mSeed{ 0 };
+      uint32_t mStepCnt{ 0 };
+      ci::Rand mRand;
+      double mDuration{ 0.0 };
+      double mGameSpeedCoef{ 1.0 };
+      double mTimePenalty{ 0.0 };
+      double mSpawningTime{ 3.0 };
+      double mScore{ 0.0 };
+      double mTime{ 0.0 };
+      int mStreakCnt{ 0 };
+      int mStreakCntFloor{ 0 };
+      int mStreakThreshold{ 5 };
+      int mStreakMaxInc{ 10 };
+      int mMaxNbToons{ 1 };
+      ci::Rectf mBounds{ 0.0f, 0.0f, 1280.0f, 800.0f };
+      KeyboardModel mKb;
+      KeyStats mKeyStats;
+      ToonPool mToons;
+      VKeyToon mKeyToonPairs;
+      VHandle mSlotToons; // the toon in game on each key slot, by slot
+      VStreakBonus mStreakBonuses;
+      VObserver mObservers;
+};
+
+inline
+KeyboardModel& GameCore::getKeyboard()
+{
+   return mKb;
+}
+
+inline
+const KeyboardModel& GameCore::getKeyboard() const
+{
+   return mKb;
+}
+
+inline
+const KeyStats& GameCore::getKeyStats() const
+{
+   return mKeyStats;
+}
+
+inline
+GameCore::State GameCore::getState() const
+{
+   return mState;
+}
+
+inline
+const GameRules& GameCore::getRules() const
+{
+   return mRules;
+}
+
+inline
+uint32_t GameCore::getSeed() const
+{
+   return mSeed;
+}
+
+inline
+uint32_t GameCore::getStepCount() const
+{
+   return mStepCnt;
+}
+
+inline
+const ci::Rectf& GameCore::getBounds() const
+{
+   return mBounds;
+}
+
+inline
+const ToonPool& GameCore::getToons() const
+{
+   return mToons;
+}
+
+inline
+double GameCore::getTime() const
+{
+   return mTime;
+}
+
+inline
+double GameCore::getDuration() const
+{
+   return mDuration;
+}
+
+inline
+double GameCore::getScore() const
+{
+   return mScore;
+}
+
+inline
+int GameCore::getStreakCnt() const
+{
+   return mStreakCnt;
+}
+
+inline
+int GameCore::getStreakThreshold() const
+{
+   return mStreakThreshold;
+}
+
+inline
+bool GameCore::isPerfectGame() const
+{
+   return mPerfectGameFlag;
+}
+
+inline
+const GameCore::VKeyToon& GameCore::getKeyToonPairs() const
+{
+   return mKeyToonPairs;
+}
+
+inline
+const GameCore::VStreakBonus& GameCore::getStreakBonuses() const
+{
+   return mStreakBonuses;
+}
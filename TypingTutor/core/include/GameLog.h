@@ -0,0 +1,66 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "KeyboardLayout.h"
+#include "Skill.h"
+
+#include "cinder/Rect.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Everything needed to play a game again: the seed, the rules, the layout the
+// game was played on and each key pressed with the simulation step it came
+// in. save() and load() use a compact binary format (see GameLog.cpp) and
+// throw std::runtime_error when the file cannot be written or read.
+struct GameLog {
+   struct KeyEvent {
+      uint32_t step;
+      int code;
+   };
+
+   using KeySize = std::pair<int, ci::vec2>;
+   using VKeyEvent = std::vector<KeyEvent>;
+   using VKeySize = std::vector<KeySize>;
+   using VSize = std::vector<ci::vec2>;
+
+   void save(const std::string& path) const;
+   static GameLog load(const std::string& path);
+
+   uint32_t seed{ 0 };
+   Skill skill{ Skill::Positioning };
+   bool adaptiveFlag{ false };
+   double duration{ 0.0 };
+   ci::Rectf bounds;
+   KeyboardLayout layout{ KeyboardLayout::qwerty() };
+   ci::vec2 keyboardTopLeft;
+   VSize toonSizes;
+   VKeySize keySizes;
+   VKeyEvent events;
+};
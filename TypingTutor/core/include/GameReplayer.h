@@ -0,0 +1,70 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "GameCore.h"
+#include "GameLog.h"
+
+// Plays a recorded game again on a GameCore of its own. The keys of the log
+// are fed back at the steps they were pressed, so the game unfolds exactly
+// as it was played. advance() keeps pace with a clock at any speed; run()
+// goes as fast as the machine allows.
+class GameReplayer {
+   public:
+      GameReplayer(const GameLog& log);
+
+      void setSpeed(double speed);
+      void advance(double seconds);
+      void run();
+      void step();
+      bool isDone() const;
+      GameCore& getCore();
+
+   private:
+      GameLog mLog;
+      GameCore mCore;
+      size_t mNextEvent{ 0 };
+      double mSpeed{ 1.0 };
+      double mAccumulator{ 0.0 };
+};
+
+inline
+void GameReplayer::setSpeed(double speed)
+{
+   mSpeed = speed;
+}
+
+inline
+bool GameReplayer::isDone() const
+{
+   return (mCore.getState() == GameCore::State::GameOver);
+}
+
+inline
+GameCore& GameReplayer::getCore()
+{
+   return mCore;
+}
@@ -0,0 +1,61 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <vector>
+
+// Draws an index with a probability proportional to its weight. The weights
+// are kept in a Fenwick tree: changing one and drawing are both O(log n), and
+// a zero weight leaves an index out of the draw.
+class KeySampler {
+   public:
+      explicit KeySampler(int size = 0);
+
+      void reset(int size);
+      void setWeight(int i, double weight);
+      void rebuild(const std::vector<double>& weights);
+      int sample(double u) const;
+      double getWeight(int i) const;
+      double getTotal() const;
+      int getSize() const;
+
+   private:
+      std::vector<double> mWeights;
+      std::vector<double> mTree; // from 1, mTree[i] sums the weights of (i - lowbit(i), i]
+      int mTopBit{ 0 };
+};
+
+inline
+double KeySampler::getWeight(int i) const
+{
+   return mWeights[i];
+}
+
+inline
+int KeySampler::getSize() const
+{
+   return static_cast<int>(mWeights.size());
+}
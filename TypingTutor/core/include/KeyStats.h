@@ -0,0 +1,73 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <vector>
+
+// The running reaction time and error rate of each key slot of a game, as
+// exponential moving averages over its last toons. A key is weighted by how
+// long it takes and how often it is missed, so the weak keys of a student
+// come back more often in an adaptive game. Keys start from a prior worse
+// than a typical student, so each one is tried early on.
+class KeyStats {
+   public:
+      static const double SMOOTHING;
+      static const double PRIOR_REACTION_TIME;
+      static const double PRIOR_ERROR_RATE;
+      static const double ERROR_COEF;
+
+      explicit KeyStats(int nbSlots);
+
+      void spawn(int slot, double time);
+      void hit(int slot, double time);
+      void miss(int slot);
+      double getReactionTime(int slot) const;
+      double getErrorRate(int slot) const;
+      double getWeight(int slot) const;
+
+   private:
+      std::vector<double> mSpawnTimes;    // by slot
+      std::vector<double> mReactionTimes; // by slot
+      std::vector<double> mErrorRates;    // by slot
+};
+
+inline
+double KeyStats::getReactionTime(int slot) const
+{
+   return mReactionTimes[slot];
+}
+
+inline
+double KeyStats::getErrorRate(int slot) const
+{
+   return mErrorRates[slot];
+}
+
+inline
+double KeyStats::getWeight(int slot) const
+{
+   return mReactionTimes[slot] * (1.0 + ERROR_COEF * mErrorRates[slot]);
+}
@@ -0,0 +1,77 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "Skill.h"
+
+#include "cinder/Color.h"
+#include "cinder/Vector.h"
+
+#include <string>
+#include <vector>
+
+// A keyboard layout: its keys, where each one sits in the grid of rows and
+// finger columns, and the geometry that places the grid on the keyboard
+// image. The finger colors and the keyboard image of each skill go with it
+// for the app. load() reads the text format described in KeyboardLayout.cpp
+// and throws std::runtime_error when the file cannot be read or is invalid.
+struct KeyboardLayout {
+   struct Key {
+      Key() = default;
+      Key(int code_, std::string c_, int row_, int col_) :
+         code(code_), c(c_), row(row_), col(col_) {}
+
+      int code{ 0 };
+      std::string c;
+      int row{ 0 };
+      int col{ 0 };
+   };
+
+   // the center of a key, from the top left of the keyboard image, is
+   // origin + (row * rowStagger + col * colPitch, row * rowPitch)
+   struct Geometry {
+      ci::vec2 origin{ 45.0f, -390.0f };
+      float colPitch{ 70.0f };
+      float rowPitch{ 75.0f };
+      float rowStagger{ 15.0f };
+   };
+
+   using VKey = std::vector<Key>;
+   using VColor = std::vector<ci::Color>;
+   using VString = std::vector<std::string>;
+
+   static KeyboardLayout qwerty();
+   static KeyboardLayout load(const std::string& path);
+
+   const ci::Color& getColColor(int col) const;
+   const std::string& getImage(Skill skill) const;
+
+   std::string name;
+   VKey keys;
+   Geometry geometry;
+   VColor colColors; // by finger column
+   VString images;   // the keyboard image of each skill, by skill
+};
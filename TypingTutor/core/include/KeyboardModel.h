@@ -0,0 +1,260 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "KeyboardLayout.h"
+#include "KeySampler.h"
+
+#include "cinder/Rect.h"
+#include "cinder/Rand.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The keys of the game keyboard: where they are, which ones are in play and
+// which ones already have a toon. They come from a KeyboardLayout; key codes
+// are those of ci::app::KeyEvent, which are the ASCII codes of the lower case
+// characters for most keys.
+//
+// Each key has a slot, its rank by key code, and the key states are bit masks
+// over the slots: enabling a row is one OR, and picking a random free key is
+// a popcount and a select of the n-th set bit. Slots are found from key
+// codes through a table indexed by code, and the key rectangles are kept per
+// slot. The layout geometry is compiled into a center per slot, so a key
+// rectangle is only recomputed when the keyboard moves or the key is resized.
+//
+// A weighted keyboard draws its random keys in proportion to a weight per
+// key instead of uniformly. The weights of the free keys are kept in a
+// KeySampler, updated as keys are selected and released, so a draw stays
+// O(log n) however many keys the layout has.
+class KeyboardModel {
+   public:
+      struct Key {
+         Key() = default;
+         Key(int code_, std::string c_, int row_, int col_) :
+            code(code_), c(c_), row(row_), col(col_) {}
+
+         int code{ 0 };
+         std::string c;
+         int row{ 0 };
+         int col{ 0 };
+         ci::vec2 size{ 60.0f, 80.0f };
+      };
+
+      using Mask = uint64_t;
+      using VKey = std::vector<Key>;
+
+      static const int KEY_UNKNOWN;
+      static const int NO_SLOT;
+      static const int MAX_KEYS = 64;
+      static const int NB_KEY_CODES = 512;
+
+      KeyboardModel(const KeyboardLayout& layout);
+
+      void enableRow(int iRow);
+      void enableCol(int iCol);
+      void disableRow(int iRow);
+      void disableCol(int iCol);
+      void selectKey(int keyCode);
+      void deselectKey(int keyCode);
+      int randSelectKey(ci::Rand& rand) const;
+      void setWeighted(bool weightedFlag);
+      bool isWeighted() const;
+      void setKeyWeight(int keyCode, double weight);
+      double getKeyWeight(int keyCode) const;
+      int getSlot(int keyCode) const;
+      int getNbSlots() const;
+      const ci::Rectf& getKeyRectf(int keyCode) const;
+      const ci::Rectf& getSlotRectf(int slot) const;
+      void setKeySize(int keyCode, const ci::vec2& size);
+      void setTopLeft(const ci::vec2& topLeft);
+      const ci::vec2& getTopLeft() const;
+      const KeyboardLayout& getLayout() const;
+      const VKey& getKeys() const;
+      const Key& getKey(int keyCode) const;
+      Mask getEnabledMask() const;
+      Mask getSelectedMask() const;
+      Mask getAvailableMask() const;
+
+   private:
+      using VMask = std::vector<Mask>;
+
+      void setLayout(const KeyboardLayout& layout);
+      void updateRect(int slot);
+      void setEnabledMask(Mask mask);
+      void updateSampler(int slot);
+      void rebuildSampler();
+      Mask getRowMask(int iRow) const;
+      Mask getColMask(int iCol) const;
+
+      KeyboardLayout mLayout;
+      VKey mKeys;
+      std::vector<int> mSlots;        // by key code
+      std::vector<ci::vec2> mCenters; // by slot, from the keyboard top left
+      std::vector<ci::Rectf> mRects;  // by slot
+      VMask mRowMasks;
+      VMask mColMasks;
+      Mask mEnabledMask{ 0 };
+      Mask mSelectedMask{ 0 };
+      ci::vec2 mTopLeft;
+      bool mWeightedFlag{ false };
+      std::vector<double> mWeights; // by slot
+      KeySampler mSampler;          // the weights of the available slots
+};
+
+inline
+void KeyboardModel::enableRow(int iRow)
+{
+   setEnabledMask(mEnabledMask | getRowMask(iRow));
+}
+
+inline
+void KeyboardModel::enableCol(int iCol)
+{
+   setEnabledMask(mEnabledMask | getColMask(iCol));
+}
+
+inline
+void KeyboardModel::disableRow(int iRow)
+{
+   setEnabledMask(mEnabledMask & ~getRowMask(iRow));
+}
+
+inline
+void KeyboardModel::disableCol(int iCol)
+{
+   setEnabledMask(mEnabledMask & ~getColMask(iCol));
+}
+
+inline
+void KeyboardModel::setEnabledMask(Mask mask)
+{
+   if (mask != mEnabledMask) {
+      mEnabledMask = mask;
+      if (mWeightedFlag) { rebuildSampler(); }
+   }
+}
+
+inline
+KeyboardModel::Mask KeyboardModel::getRowMask(int iRow) const
+{
+   return (0 <= iRow && iRow < static_cast<int>(mRowMasks.size())) ? mRowMasks[iRow] : 0;
+}
+
+inline
+KeyboardModel::Mask KeyboardModel::getColMask(int iCol) const
+{
+   return (0 <= iCol && iCol < static_cast<int>(mColMasks.size())) ? mColMasks[iCol] : 0;
+}
+
+inline
+int KeyboardModel::getSlot(int keyCode) const
+{
+   return (0 <= keyCode && keyCode < NB_KEY_CODES) ? mSlots[keyCode] : NO_SLOT;
+}
+
+inline
+int KeyboardModel::getNbSlots() const
+{
+   return static_cast<int>(mKeys.size());
+}
+
+inline
+const ci::Rectf& KeyboardModel::getKeyRectf(int keyCode) const
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT);
+
+   return mRects[slot];
+}
+
+inline
+const ci::Rectf& KeyboardModel::getSlotRectf(int slot) const
+{
+   return mRects[slot];
+}
+
+inline
+const ci::vec2& KeyboardModel::getTopLeft() const
+{
+   return mTopLeft;
+}
+
+inline
+bool KeyboardModel::isWeighted() const
+{
+   return mWeightedFlag;
+}
+
+inline
+double KeyboardModel::getKeyWeight(int keyCode) const
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT);
+
+   return mWeights[slot];
+}
+
+inline
+const KeyboardLayout& KeyboardModel::getLayout() const
+{
+   return mLayout;
+}
+
+inline
+const KeyboardModel::VKey& KeyboardModel::getKeys() const
+{
+   return mKeys;
+}
+
+inline
+const KeyboardModel::Key& KeyboardModel::getKey(int keyCode) const
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT);
+
+   return mKeys[slot];
+}
+
+inline
+KeyboardModel::Mask KeyboardModel::getEnabledMask() const
+{
+   return mEnabledMask;
+}
+
+inline
+KeyboardModel::Mask KeyboardModel::getSelectedMask() const
+{
+   return mSelectedMask;
+}
+
+inline
+KeyboardModel::Mask KeyboardModel::getAvailableMask() const
+{
+   return mEnabledMask & ~mSelectedMask;
+}
@@ -0,0 +1,80 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A file mapped into memory by the constructor. In ReadWrite mode the file
+// is created if need be; resize() grows or shrinks it and maps it again,
+// which moves data(), or leaves it as it was when it throws. writeThrough()
+// writes bytes at an offset through the file handle and waits for the disk;
+// it does not touch the mapping, so it may run on another thread while the
+// mapping moves. A ReadOnly mapping must exist and lets other processes
+// write the file. Failures throw std::runtime_error.
+class MappedFile {
+   public:
+      enum class Mode{ ReadWrite, ReadOnly };
+
+      MappedFile(const std::string& path, Mode mode);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      void resize(size_t size);
+      void writeThrough(size_t offset, const uint8_t* pBytes, size_t length);
+      uint8_t* data() const;
+      size_t size() const;
+
+   private:
+      void map();
+      void unmap();
+
+      std::string mPath;
+      Mode mMode{ Mode::ReadWrite };
+      uint8_t* mData{ nullptr };
+      size_t mSize{ 0 };
+#ifdef _WIN32
+      void* mFile{ nullptr };
+      void* mMapping{ nullptr };
+#else
+      int mFile{ -1 };
+#endif
+};
+
+inline
+uint8_t* MappedFile::data() const
+{
+   return mData;
+}
+
+inline
+size_t MappedFile::size() const
+{
+   return mSize;
+}
@@ -0,0 +1,129 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "MappedFile.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What happened in a game, one fixed-size record per event. step is the
+// simulation step of the event and value depends on the type:
+//    Start    step is the start time in seconds since 1970, code the skill,
+//             value the duration of the game
+//    Hit      the key of a toon in game was pressed; value is the reaction
+//             time, in seconds from the spawn of the toon
+//    Miss     a key without a toon in game was pressed
+//    Escape   a toon escaped; value is how long its key went unpressed
+//    Streak   a streak bonus; value is the bonus
+//    End      the game is over; value is the score
+//    Layout   right after Start, the name of the keyboard layout, eight
+//             characters per record in the bytes of step and value; code
+//             is their offset in the name, with LAST_PIECE set on the last
+struct SessionRecord {
+   enum Type : uint8_t { None, Start, Hit, Miss, Escape, Streak, End, Layout, Last };
+
+   static const uint16_t LAST_PIECE;
+
+   uint32_t session;
+   uint32_t step;
+   float value;
+   uint16_t code;
+   uint8_t type;
+   uint8_t check;
+};
+
+static_assert(sizeof(SessionRecord) == 16, "session records are 16 bytes on disk");
+
+// The append-only log of the games of one student. The file is mapped in
+// memory and grown in chunks, so append() is a copy into the mapping; a
+// thread writes what was appended to the disk about once a second, holding
+// the lock that keeps the mapping in place only to copy the new records.
+// Every record carries a check byte: when the log is opened after a crash,
+// the records are read up to the first one that is blank or torn, and the
+// next appends go there. The file is cut to its records when the log
+// closes. Failures to open the file throw std::runtime_error. When the file
+// cannot grow, on Windows while another process has it mapped, the records
+// wait in memory and the next append tries again. Records that cannot be
+// written are kept for the next flush; the failures, and the records still
+// lost when the log closes, go to the error callback, which may be called
+// from the flush thread.
+//
+// Readers can load() a log, or map it read-only and walk getRecords() up to
+// the first record that is not valid.
+class SessionLog {
+   public:
+      using VRecord = std::vector<SessionRecord>;
+      using ErrorCallback = std::function<void(const std::string& message)>;
+
+      SessionLog(const std::string& path, const ErrorCallback& onError = ErrorCallback());
+      ~SessionLog();
+
+      uint32_t beginSession();
+      void append(SessionRecord record);
+      int getNbRecords() const;
+
+      static VRecord load(const std::string& path);
+      static bool isValid(const SessionRecord& record);
+      static const SessionRecord* getRecords(const MappedFile& file, int* pNbRecords);
+
+   private:
+      static const size_t HEADER_SIZE;
+      static const size_t CHUNK_SIZE;
+      static const double FLUSH_PERIOD;
+
+      static uint8_t computeCheck(const SessionRecord& record);
+
+      bool writeBacklog();
+      void flush(std::unique_lock<std::mutex>* pLock);
+      void work();
+
+      std::string mPath;
+      ErrorCallback mOnError;
+      MappedFile mFile;
+      VRecord mBacklog; // appended, not yet in the file
+      std::vector<uint8_t> mFlushBytes;
+      bool mFlushErrorFlag{ false };
+      uint32_t mNextSession{ 0 };
+      std::atomic<int> mNbRecords{ 0 };
+      int mNbFlushed{ 0 };
+      bool mStopFlag{ false };
+      std::mutex mMutex;
+      std::condition_variable mCondition;
+      std::thread mThread;
+};
+
+inline
+int SessionLog::getNbRecords() const
+{
+   return mNbRecords;
+}
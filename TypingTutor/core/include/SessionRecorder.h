@@ -0,0 +1,58 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "GameCore.h"
+#include "GameObserver.h"
+#include "SessionLog.h"
+
+#include <vector>
+
+// Appends what happens in a game to a student's SessionLog: a Start record
+// and the name of the layout when it is built, then one record per key hit
+// or missed, escape and streak bonus. finish() adds the End record; a game
+// left before it is over has none.
+class SessionRecorder : public GameObserver {
+   public:
+      SessionRecorder(GameCore* pCore, SessionLog* pLog);
+
+      virtual void onToonSpawned(int keyCode) override;
+      virtual void onToonHurled(int keyCode, double score) override;
+      virtual void onToonEscaped(int keyCode) override;
+      virtual void onWrongKey(int keyCode) override;
+      virtual void onStreakBonus(double bonus) override;
+
+      void finish();
+
+   private:
+      void append(SessionRecord::Type type, int keyCode, double value);
+      double getTimeSinceSpawn(int keyCode) const;
+
+      GameCore* mCorePtr{ nullptr };
+      SessionLog* mLogPtr{ nullptr };
+      uint32_t mSession{ 0 };
+      std::vector<uint32_t> mSpawnSteps; // by key slot
+};
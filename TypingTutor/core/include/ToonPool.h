@@ -0,0 +1,132 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/Rect.h"
+#include "cinder/Rand.h"
+
+#include <vector>
+
+// The toons of a game: their state machine and motion, stepped by GameCore
+// with the game's own random generator. A toon is known by its handle, its
+// index in the pool, which is also the index of its image; handles stay
+// valid for the life of the pool.
+//
+// The fields of the toons are kept in parallel arrays, so stepping them walks
+// contiguous memory. The available toons are kept in a free list: taking one
+// and giving it back are both constant time, as is counting those in game.
+class ToonPool {
+   public:
+      using Handle = int;
+
+      static const Handle NO_TOON;
+
+      ToonPool(double reducedTimeCoef);
+
+      Handle add(const ci::vec2& size);
+      int getSize() const;
+      int getNbAvailable() const;
+      int getNbInGame() const;
+      Handle spawnAvailable(int n);
+      bool update(Handle toon, double dt, const ci::Rectf& keyRect, const ci::Rectf& bounds, ci::Rand& rand);
+      double hurl(Handle toon, ci::Rand& rand);
+      bool isAvailable(Handle toon) const;
+      bool isInGame(Handle toon) const;
+      bool isHurled(Handle toon) const;
+      ci::Rectf getRect(Handle toon, double alpha) const;
+      const ci::vec2& getToonSize(Handle toon) const;
+
+   private:
+      enum class State : unsigned char { Available, Spawning, InGame, Hurled, Escaping };
+
+      static const double SPAWNING_DURATION;
+      static const double ESCAPING_DURATION;
+      static const double INGAME_DURATION;
+      static const double SHAKING_DURATION;
+      static const double GRAVITY;
+
+      void setState(Handle toon, State state);
+      void retire(Handle toon);
+      ci::Rectf computeRect(Handle toon, const ci::Rectf& keyRect, ci::Rand& rand) const;
+
+      bool mCanEscapeFlag{ false };
+      double mIngameDuration{ 0.0 };
+      double mShakingDuration{ 0.0 };
+      int mNbInGame{ 0 };
+      std::vector<Handle> mAvailable;
+
+      // one entry per toon
+      std::vector<State> mStates;
+      std::vector<double> mTimes;
+      std::vector<double> mScores;
+      std::vector<double> mAngles;
+      std::vector<char> mSnapFlags;
+      std::vector<ci::Rectf> mRects;
+      std::vector<ci::Rectf> mPrevRects;
+      std::vector<ci::vec2> mSizes;
+};
+
+inline
+int ToonPool::getSize() const
+{
+   return static_cast<int>(mStates.size());
+}
+
+inline
+int ToonPool::getNbAvailable() const
+{
+   return static_cast<int>(mAvailable.size());
+}
+
+inline
+int ToonPool::getNbInGame() const
+{
+   return mNbInGame;
+}
+
+inline
+bool ToonPool::isAvailable(Handle toon) const
+{
+   return (mStates[toon] == State::Available);
+}
+
+inline 
+bool ToonPool::isInGame(Handle toon) const
+{
+   return (mStates[toon] == State::InGame);
+}
+
+inline
+bool ToonPool::isHurled(Handle toon) const
+{
+   return (mStates[toon] == State::Hurled);
+}
+
+inline
+const ci::vec2& ToonPool::getToonSize(Handle toon) const
+{
+   return mSizes[toon];
+}
@@ -0,0 +1,275 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameCore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+using namespace ci;
+
+const double GameCore::TIME_STEP = 1.0 / 120.0;
+const double GameCore::STREAK_BONUS_EXPIRATION = 1.0;
+
+GameCore::GameCore(const GameRules& rules, const KeyboardLayout& layout, uint32_t seed) :
+mRules(rules),
+mSeed(seed),
+mRand(seed),
+mDuration(rules.duration),
+mGameSpeedCoef(rules.gameSpeedCoef),
+mStreakMaxInc(rules.streakMaxInc),
+mMaxNbToons(rules.maxNbToons),
+mKb(layout),
+mKeyStats(mKb.getNbSlots()),
+mToons(rules.gameSpeedCoef),
+mSlotToons(mKb.getNbSlots(), ToonPool::NO_TOON)
+{
+   for (const auto iRow : rules.enabledRows) {
+      mKb.enableRow(iRow);
+   }
+   for (const auto iCol : rules.disabledCols) {
+      mKb.disableCol(iCol);
+   }
+   mKb.setWeighted(rules.adaptiveFlag);
+   for (const auto& rKey : mKb.getKeys()) {
+      mKb.setKeyWeight(rKey.code, mKeyStats.getWeight(mKb.getSlot(rKey.code)));
+   }
+
+   // a headless game gets a keyboard along the bottom of the default bounds
+   mKb.setTopLeft(vec2(mBounds.x1, mBounds.y2));
+}
+
+void GameCore::addToon(const vec2& size)
+{
+   // the pool is filled before the game starts
+   assert(mKeyToonPairs.empty());
+
+   mToons.add(size);
+}
+
+void GameCore::addObserver(GameObserver* pObserver)
+{
+   assert(pObserver != nullptr);
+   mObservers.push_back(pObserver);
+}
+
+void GameCore::setBounds(const Rectf& bounds)
+{
+   mBounds = bounds;
+}
+
+void GameCore::step()
+{
+   ++mStepCnt;
+   mTime += TIME_STEP;
+
+   if (mTime + mTimePenalty > mDuration) {
+      mState = State::GameOver;
+   }
+
+   if (mState == State::GameOver) {
+      if (mPerfectGameBonusOnceFlag && mPerfectGameFlag) {
+         mPerfectGameBonusOnceFlag = false;
+         newStreakBonus(mScore, mBounds.getCenter());
+      }
+      // the hurled toons finish their flight; the others stay frozen
+      stepToons(true);
+   }
+   else {
+      if (mTime > mSpawningTime) {
+
+         if (mState == State::Preset) {
+            mState = State::Playing;
+            mTime = 0.0;
+         }
+
+         const auto iAvailable = randSelectToon();
+         const auto key = mKb.randSelectKey(mRand);
+         if (iAvailable >= 0 && key != KeyboardModel::KEY_UNKNOWN) {
+            const auto toon = mToons.spawnAvailable(iAvailable);
+            mKeyToonPairs.emplace_back(key, toon);
+            const auto slot = mKb.getSlot(key);
+            mSlotToons[slot] = toon;
+            mKeyStats.spawn(slot, mTime);
+            mKb.selectKey(key);
+            for (auto pObserver : mObservers) { pObserver->onToonSpawned(key); }
+         }
+         updateNextSpawingTime();
+      }
+
+      stepToons(false);
+   }
+
+   pruneStreakBonuses(&mStreakBonuses, mTime);
+}
+
+void GameCore::pruneStreakBonuses(VStreakBonus* pBonuses, double time)
+{
+   pBonuses->erase(
+      std::remove_if(
+         pBonuses->begin(),
+         pBonuses->end(),
+         [time](const StreakBonus& r){ return time > r.expiration; }),
+      pBonuses->end());
+}
+
+void GameCore::stepToons(bool hurledOnlyFlag)
+{
+   for (auto& i : mKeyToonPairs) {
+      const auto keyCode = i.first;
+      const auto toon = i.second;
+      if (hurledOnlyFlag && !mToons.isHurled(toon)) {
+         continue;
+      }
+      const auto escapedFlag = mToons.update(toon, TIME_STEP, mKb.getKeyRectf(keyCode), mBounds, mRand);
+      if (escapedFlag) {
+         resetStreakCount();
+         const auto slot = mKb.getSlot(keyCode);
+         mSlotToons[slot] = ToonPool::NO_TOON;
+         mKeyStats.miss(slot);
+         updateKeyWeight(keyCode, slot);
+         mKb.deselectKey(keyCode);
+         for (auto pObserver : mObservers) { pObserver->onToonEscaped(keyCode); }
+      }
+      else if (mToons.isAvailable(toon)) {
+         // it left the bounds; the key may have a new toon already
+         auto& rSlotToon = mSlotToons[mKb.getSlot(keyCode)];
+         if (rSlotToon == toon) {
+            rSlotToon = ToonPool::NO_TOON;
+         }
+      }
+   }
+
+   mKeyToonPairs.erase(
+      std::remove_if(
+         mKeyToonPairs.begin(),
+         mKeyToonPairs.end(),
+         [this](const KeyToonPair& r){ return mToons.isAvailable(r.second); }),
+      mKeyToonPairs.end());
+}
+
+int GameCore::randSelectToon()
+{
+   // the position in the pool's free list of the toon to spawn, or -1
+   if (mToons.getNbInGame() < mMaxNbToons) {
+      const auto nbAvailableToons = mToons.getNbAvailable();
+      if (nbAvailableToons > 0) {
+         return mRand.nextInt(nbAvailableToons);
+      }
+   }
+   return -1;
+}
+
+void GameCore::updateNextSpawingTime()
+{
+   const auto randNumber = mRand.nextFloat(0.3f, 1.0f);
+   const auto timeCoef = (mGameSpeedCoef > 0.0) ? mGameSpeedCoef : 1.0;
+   mSpawningTime = mTime + timeCoef * randNumber;
+}
+
+double GameCore::computeFillRatio(double time) const
+{
+   if (mState == State::Preset) {
+      const auto ratio = 1.0 - std::min(time / mSpawningTime, 1.0);
+      return ratio; 
+   }
+
+   const auto ratio = std::min((time + mTimePenalty) / mDuration, 1.0);
+   return ratio;
+}
+
+void GameCore::keyDown(int code)
+{
+   for (auto pObserver : mObservers) { pObserver->onKeyDown(code); }
+
+   if (mState != State::Playing) {
+      return;
+   }
+
+   // a key has at most one toon in game, the one in its slot
+   const auto slot = mKb.getSlot(code);
+   const auto toon = (slot != KeyboardModel::NO_SLOT) ? mSlotToons[slot] : ToonPool::NO_TOON;
+   const auto hitFlag = (toon != ToonPool::NO_TOON && mToons.isInGame(toon));
+
+   if (hitFlag) {
+      mSlotToons[slot] = ToonPool::NO_TOON;
+      mKeyStats.hit(slot, mTime);
+      updateKeyWeight(code, slot);
+      mKb.deselectKey(code);
+      const auto score = mToons.hurl(toon, mRand);
+      for (auto pObserver : mObservers) { pObserver->onToonHurled(code, score); }
+      mScore += score;
+      incStreakCount(code);
+   }
+   else {
+      mTimePenalty += 1.0;
+      if (slot != KeyboardModel::NO_SLOT) {
+         // the finger went to this key; it is the one mixed up
+         mKeyStats.miss(slot);
+         updateKeyWeight(code, slot);
+      }
+      for (auto pObserver : mObservers) { pObserver->onWrongKey(code); }
+      resetStreakCount();
+   }
+}
+
+void GameCore::updateKeyWeight(int keyCode, int slot)
+{
+   mKb.setKeyWeight(keyCode, mKeyStats.getWeight(slot));
+}
+
+void GameCore::incStreakCount(int keyCode)
+{
+   if (++mStreakCnt == mStreakThreshold) {
+      mStreakCntFloor = mStreakCnt;
+      const auto pos = mKb.getKeyRectf(keyCode).getCenter();
+      const auto bonus = 10 * mStreakThreshold;
+      newStreakBonus(bonus, pos);
+      const auto streakAdd = std::min(mStreakThreshold, mStreakMaxInc);
+      mStreakThreshold += streakAdd;
+   }
+}
+
+void GameCore::newStreakBonus(double bonus, vec2 pos)
+{
+   std::ostringstream bonusStringStream;
+   bonusStringStream << "+" << bonus;
+
+   StreakBonus streakBonus;
+   streakBonus.pos = pos;
+   streakBonus.bonus = bonusStringStream.str();
+   streakBonus.expiration = mTime + STREAK_BONUS_EXPIRATION;
+   mStreakBonuses.emplace_back(streakBonus);
+   
+   mScore += bonus;
+   for (auto pObserver : mObservers) { pObserver->onStreakBonus(bonus); }
+}
+
+void GameCore::resetStreakCount()
+{
+   mStreakCnt = mStreakCntFloor;
+   mPerfectGameFlag = false;
+}
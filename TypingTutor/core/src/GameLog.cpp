@@ -0,0 +1,260 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameLog.h"
+#include "KeyboardModel.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+// File layout, all in the byte order of the machine that wrote it:
+//    "TTR4"                              magic and version
+//    u32 seed, u8 skill, u8 adaptive, f64 duration
+//    f32 x4 bounds
+//    name, f32 x5 geometry               keyboard layout
+//    n, then n times code, row, col, label
+//    f32 x2 keyboard top left
+//    n, then n times f32 x2              toon sizes
+//    n, then n times code, f32 x2        key sizes
+//    n, then n times step delta, code    key presses
+// where n, codes, rows, columns and step deltas are unsigned LEB128 varints
+// and strings are a varint length and the bytes. The finger colors and the
+// images of the layout are not kept; a replay draws nothing. A key press
+// costs two or three bytes in a typical game.
+
+namespace {
+   const char MAGIC[4] = { 'T', 'T', 'R', '4' };
+
+   template<typename T>
+   void write(std::ostream& os, T value)
+   {
+      os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+   }
+
+   template<typename T>
+   T read(std::istream& is)
+   {
+      T value;
+      is.read(reinterpret_cast<char*>(&value), sizeof(T));
+      return value;
+   }
+
+   void writeVarint(std::ostream& os, uint32_t value)
+   {
+      while (value >= 0x80) {
+         os.put(static_cast<char>((value & 0x7F) | 0x80));
+         value >>= 7;
+      }
+      os.put(static_cast<char>(value));
+   }
+
+   uint32_t readVarint(std::istream& is)
+   {
+      uint32_t value = 0;
+      for (auto shift = 0; shift < 35; shift += 7) {
+         const auto byte = is.get();
+         if (byte == std::char_traits<char>::eof()) {
+            break;
+         }
+         value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+         if ((byte & 0x80) == 0) {
+            return value;
+         }
+      }
+      throw std::runtime_error("truncated game log");
+   }
+
+   void writeVec2(std::ostream& os, const ci::vec2& v)
+   {
+      write<float>(os, v.x);
+      write<float>(os, v.y);
+   }
+
+   ci::vec2 readVec2(std::istream& is)
+   {
+      const auto x = read<float>(is);
+      const auto y = read<float>(is);
+      return ci::vec2(x, y);
+   }
+
+   void writeString(std::ostream& os, const std::string& s)
+   {
+      writeVarint(os, static_cast<uint32_t>(s.size()));
+      os.write(s.data(), s.size());
+   }
+
+   std::string readString(std::istream& is)
+   {
+      const auto size = readVarint(is);
+      if (size > 0xFFFF) {
+         throw std::runtime_error("bad string in game log");
+      }
+      std::string s(size, '\0');
+      is.read(&s[0], size);
+      return s;
+   }
+
+   void writeLayout(std::ostream& os, const KeyboardLayout& layout)
+   {
+      writeString(os, layout.name);
+      writeVec2(os, layout.geometry.origin);
+      write<float>(os, layout.geometry.colPitch);
+      write<float>(os, layout.geometry.rowPitch);
+      write<float>(os, layout.geometry.rowStagger);
+
+      writeVarint(os, static_cast<uint32_t>(layout.keys.size()));
+      for (const auto& rKey : layout.keys) {
+         writeVarint(os, static_cast<uint32_t>(rKey.code));
+         writeVarint(os, static_cast<uint32_t>(rKey.row));
+         writeVarint(os, static_cast<uint32_t>(rKey.col));
+         writeString(os, rKey.c);
+      }
+   }
+
+   KeyboardLayout readLayout(std::istream& is)
+   {
+      // the colors and images are the default ones
+      auto layout = KeyboardLayout::qwerty();
+      layout.name = readString(is);
+      layout.geometry.origin = readVec2(is);
+      layout.geometry.colPitch = read<float>(is);
+      layout.geometry.rowPitch = read<float>(is);
+      layout.geometry.rowStagger = read<float>(is);
+
+      layout.keys.clear();
+      const auto nbKeys = readVarint(is);
+      if (nbKeys > KeyboardModel::MAX_KEYS) {
+         throw std::runtime_error("too many keys in game log");
+      }
+      for (auto i = 0u; i < nbKeys; ++i) {
+         KeyboardLayout::Key key;
+         key.code = static_cast<int>(readVarint(is));
+         key.row = static_cast<int>(readVarint(is));
+         key.col = static_cast<int>(readVarint(is));
+         key.c = readString(is);
+         if (key.code <= 0 || key.code >= KeyboardModel::NB_KEY_CODES || key.row >= KeyboardModel::MAX_KEYS || key.col >= KeyboardModel::MAX_KEYS) {
+            throw std::runtime_error("bad key in game log");
+         }
+         layout.keys.push_back(key);
+      }
+      return layout;
+   }
+}
+
+void GameLog::save(const std::string& path) const
+{
+   std::ofstream ofs(path, std::ios::binary);
+   if (!ofs) {
+      throw std::runtime_error("cannot write game log " + path);
+   }
+
+   ofs.write(MAGIC, sizeof(MAGIC));
+   write<uint32_t>(ofs, seed);
+   write<uint8_t>(ofs, static_cast<uint8_t>(skill));
+   write<uint8_t>(ofs, adaptiveFlag ? 1 : 0);
+   write<double>(ofs, duration);
+   writeVec2(ofs, bounds.getUpperLeft());
+   writeVec2(ofs, bounds.getLowerRight());
+   writeLayout(ofs, layout);
+   writeVec2(ofs, keyboardTopLeft);
+
+   writeVarint(ofs, static_cast<uint32_t>(toonSizes.size()));
+   for (const auto& size : toonSizes) {
+      writeVec2(ofs, size);
+   }
+
+   writeVarint(ofs, static_cast<uint32_t>(keySizes.size()));
+   for (const auto& i : keySizes) {
+      writeVarint(ofs, static_cast<uint32_t>(i.first));
+      writeVec2(ofs, i.second);
+   }
+
+   writeVarint(ofs, static_cast<uint32_t>(events.size()));
+   auto lastStep = 0u;
+   for (const auto& event : events) {
+      writeVarint(ofs, event.step - lastStep);
+      writeVarint(ofs, static_cast<uint32_t>(event.code));
+      lastStep = event.step;
+   }
+
+   if (!ofs) {
+      throw std::runtime_error("cannot write game log " + path);
+   }
+}
+
+GameLog GameLog::load(const std::string& path)
+{
+   std::ifstream ifs(path, std::ios::binary);
+   if (!ifs) {
+      throw std::runtime_error("cannot open game log " + path);
+   }
+
+   char magic[sizeof(MAGIC)] = {};
+   ifs.read(magic, sizeof(magic));
+   if (!std::equal(magic, magic + sizeof(magic), MAGIC)) {
+      throw std::runtime_error("not a game log: " + path);
+   }
+
+   GameLog log;
+   log.seed = read<uint32_t>(ifs);
+   const auto skill = read<uint8_t>(ifs);
+   if (skill >= static_cast<uint8_t>(Skill::Last)) {
+      throw std::runtime_error("unknown skill in game log " + path);
+   }
+   log.skill = static_cast<Skill>(skill);
+   log.adaptiveFlag = (read<uint8_t>(ifs) != 0);
+   log.duration = read<double>(ifs);
+   const auto upperLeft = readVec2(ifs);
+   const auto lowerRight = readVec2(ifs);
+   log.bounds = ci::Rectf(upperLeft, lowerRight);
+   log.layout = readLayout(ifs);
+   log.keyboardTopLeft = readVec2(ifs);
+
+   const auto nbToons = readVarint(ifs);
+   for (auto i = 0u; i < nbToons; ++i) {
+      log.toonSizes.push_back(readVec2(ifs));
+   }
+
+   const auto nbKeys = readVarint(ifs);
+   for (auto i = 0u; i < nbKeys; ++i) {
+      const auto code = static_cast<int>(readVarint(ifs));
+      log.keySizes.emplace_back(code, readVec2(ifs));
+   }
+
+   const auto nbEvents = readVarint(ifs);
+   auto step = 0u;
+   for (auto i = 0u; i < nbEvents; ++i) {
+      step += readVarint(ifs);
+      const auto code = static_cast<int>(readVarint(ifs));
+      log.events.push_back({ step, code });
+   }
+
+   if (!ifs) {
+      throw std::runtime_error("truncated game log " + path);
+   }
+
+   return log;
+}
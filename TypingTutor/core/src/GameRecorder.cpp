@@ -0,0 +1,67 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameRecorder.h"
+
+#include <cassert>
+
+GameRecorder::GameRecorder(GameCore* pCore) :
+mCorePtr(pCore)
+{
+   assert(mCorePtr != nullptr);
+   mCorePtr->addObserver(this);
+}
+
+void GameRecorder::onKeyDown(int keyCode)
+{
+   // the key is handled before the next step, so that is where it replays
+   mEvents.push_back({ mCorePtr->getStepCount(), keyCode });
+}
+
+GameLog GameRecorder::getLog() const
+{
+   const auto& rRules = mCorePtr->getRules();
+
+   GameLog log;
+   log.seed = mCorePtr->getSeed();
+   log.skill = rRules.skill;
+   log.adaptiveFlag = rRules.adaptiveFlag;
+   log.duration = rRules.duration;
+   log.bounds = mCorePtr->getBounds();
+   log.layout = mCorePtr->getKeyboard().getLayout();
+   log.keyboardTopLeft = mCorePtr->getKeyboard().getTopLeft();
+
+   const auto& rToons = mCorePtr->getToons();
+   for (auto toon = 0; toon < rToons.getSize(); ++toon) {
+      log.toonSizes.push_back(rToons.getToonSize(toon));
+   }
+
+   for (const auto& rKey : mCorePtr->getKeyboard().getKeys()) {
+      log.keySizes.emplace_back(rKey.code, rKey.size);
+   }
+
+   log.events = mEvents;
+   return log;
+}
@@ -0,0 +1,71 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameReplayer.h"
+
+GameReplayer::GameReplayer(const GameLog& log) :
+mLog(log),
+mCore(GameRules::forSkill(log.skill, log.duration, log.adaptiveFlag), log.layout, log.seed)
+{
+   mCore.setBounds(mLog.bounds);
+
+   auto& rKb = mCore.getKeyboard();
+   rKb.setTopLeft(mLog.keyboardTopLeft);
+   for (const auto& i : mLog.keySizes) {
+      rKb.setKeySize(i.first, i.second);
+   }
+
+   for (const auto& size : mLog.toonSizes) {
+      mCore.addToon(size);
+   }
+}
+
+void GameReplayer::advance(double seconds)
+{
+   mAccumulator += seconds * mSpeed;
+
+   while (mAccumulator >= GameCore::TIME_STEP && !isDone()) {
+      mAccumulator -= GameCore::TIME_STEP;
+      step();
+   }
+}
+
+void GameReplayer::run()
+{
+   while (!isDone()) {
+      step();
+   }
+}
+
+void GameReplayer::step()
+{
+   const auto stepCnt = mCore.getStepCount();
+   while (mNextEvent < mLog.events.size() && mLog.events[mNextEvent].step == stepCnt) {
+      mCore.keyDown(mLog.events[mNextEvent].code);
+      ++mNextEvent;
+   }
+
+   mCore.step();
+}
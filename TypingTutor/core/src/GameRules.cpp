@@ -0,0 +1,67 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameRules.h"
+
+GameRules GameRules::forSkill(Skill skill, double duration, bool adaptiveFlag)
+{
+   GameRules rules;
+   rules.skill = skill;
+   rules.duration = duration;
+   rules.adaptiveFlag = adaptiveFlag;
+
+   switch (skill) {
+      case Skill::Positioning: {
+         rules.gameSpeedCoef = 0.0;
+         rules.enabledRows = { 2 };
+         rules.disabledCols = { 4, 5 };
+      } break;
+
+      case Skill::HomeRow: {
+         rules.gameSpeedCoef = 1.0;
+         rules.maxNbToons = 2;
+         rules.streakMaxInc = 20;
+         rules.enabledRows = { 2 };
+      } break;
+
+      case Skill::Letters: {
+         rules.gameSpeedCoef = 0.8;
+         rules.maxNbToons = 3;
+         rules.streakMaxInc = 40;
+         rules.enabledRows = { 1, 2, 3 };
+      } break;
+
+      case Skill::Numbers: {
+         rules.gameSpeedCoef = 0.6;
+         rules.maxNbToons = 4;
+         rules.streakMaxInc = 80;
+         rules.enabledRows = { 0, 1, 2, 3 };
+      } break;
+
+      default: break;
+   }
+
+   return rules;
+}
@@ -0,0 +1,104 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "KeySampler.h"
+
+#include <cassert>
+
+KeySampler::KeySampler(int size)
+{
+   reset(size);
+}
+
+void KeySampler::reset(int size)
+{
+   mWeights.assign(size, 0.0);
+   mTree.assign(size + 1, 0.0);
+   for (mTopBit = 1; mTopBit <= size; mTopBit <<= 1) {}
+   mTopBit >>= 1;
+}
+
+void KeySampler::setWeight(int i, double weight)
+{
+   assert(0 <= i && i < getSize() && weight >= 0.0);
+
+   const auto delta = weight - mWeights[i];
+   if (delta == 0.0) {
+      return;
+   }
+   mWeights[i] = weight;
+   for (auto j = i + 1; j <= getSize(); j += j & -j) {
+      mTree[j] += delta;
+   }
+}
+
+void KeySampler::rebuild(const std::vector<double>& weights)
+{
+   // O(n), and it clears the rounding errors of the updates
+   assert(weights.size() == mWeights.size());
+
+   mWeights = weights;
+   for (auto j = 1; j <= getSize(); ++j) {
+      mTree[j] = mWeights[j - 1];
+   }
+   for (auto j = 1; j <= getSize(); ++j) {
+      const auto parent = j + (j & -j);
+      if (parent <= getSize()) {
+         mTree[parent] += mTree[j];
+      }
+   }
+}
+
+double KeySampler::getTotal() const
+{
+   auto total = 0.0;
+   for (auto j = getSize(); j > 0; j -= j & -j) {
+      total += mTree[j];
+   }
+   return total;
+}
+
+int KeySampler::sample(double u) const
+{
+   // the first index whose prefix sum goes past u, found by walking down the
+   // tree from its top bit; -1 if every weight is zero
+   auto pos = 0;
+   for (auto step = mTopBit; step > 0; step >>= 1) {
+      const auto next = pos + step;
+      if (next <= getSize() && mTree[next] <= u) {
+         pos = next;
+         u -= mTree[next];
+      }
+   }
+
+   // rounding can land past the end or on a zero weight next to the pick
+   for (auto i = pos; i >= 0; --i) {
+      if (i < getSize() && mWeights[i] > 0.0) { return i; }
+   }
+   for (auto i = pos + 1; i < getSize(); ++i) {
+      if (mWeights[i] > 0.0) { return i; }
+   }
+   return -1;
+}
@@ -0,0 +1,58 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "KeyStats.h"
+
+#include <algorithm>
+
+const double KeyStats::SMOOTHING = 0.3;
+const double KeyStats::PRIOR_REACTION_TIME = 1.5;
+const double KeyStats::PRIOR_ERROR_RATE = 0.2;
+const double KeyStats::ERROR_COEF = 4.0;
+
+KeyStats::KeyStats(int nbSlots) :
+mSpawnTimes(nbSlots, 0.0),
+mReactionTimes(nbSlots, PRIOR_REACTION_TIME),
+mErrorRates(nbSlots, PRIOR_ERROR_RATE)
+{
+}
+
+void KeyStats::spawn(int slot, double time)
+{
+   mSpawnTimes[slot] = time;
+}
+
+void KeyStats::hit(int slot, double time)
+{
+   // a toon waiting through the whole game should not drown the others
+   const auto reactionTime = std::min(std::max(time - mSpawnTimes[slot], 0.05), 5.0);
+   mReactionTimes[slot] += SMOOTHING * (reactionTime - mReactionTimes[slot]);
+   mErrorRates[slot] += SMOOTHING * (0.0 - mErrorRates[slot]);
+}
+
+void KeyStats::miss(int slot)
+{
+   mErrorRates[slot] += SMOOTHING * (1.0 - mErrorRates[slot]);
+}
@@ -0,0 +1,179 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "KeyboardLayout.h"
+#include "KeyboardModel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+// Layout files are text, one directive per line; blank lines and lines
+// starting with # are skipped:
+//    name <name>
+//    geometry <origin x> <origin y> <column pitch> <row pitch> <row stagger>
+//    color <column> <red> <green> <blue>       finger color, 0 to 255
+//    image <skill> <path>                      positioning, home_row, letters or numbers
+//    key <row> <column> <code> <label>
+// A key code of one character is the code of that character, which is the
+// KeyEvent code of the key that types it on an unshifted keyboard; a longer
+// one is a KeyEvent code in decimal. The geometry, colors and images default
+// to those of the QWERTY layout.
+
+namespace {
+   const char* const SKILL_NAMES[] = { "positioning", "home_row", "letters", "numbers" };
+
+   ci::Color rgb(int r, int g, int b)
+   {
+      return ci::Color(r / 255.0f, g / 255.0f, b / 255.0f);
+   }
+}
+
+KeyboardLayout KeyboardLayout::qwerty()
+{
+   KeyboardLayout layout;
+   layout.name = "QWERTY";
+   layout.keys = {
+      Key('1', "1", 0, 0), Key('2', "2", 0, 1), Key('3', "3", 0, 2), Key('4', "4", 0, 3), Key('5', "5", 0, 4),
+      Key('6', "6", 0, 5), Key('7', "7", 0, 6), Key('8', "8", 0, 7), Key('9', "9", 0, 8), Key('0', "0", 0, 9),
+      Key('q', "Q", 1, 0), Key('w', "W", 1, 1), Key('e', "E", 1, 2), Key('r', "R", 1, 3), Key('t', "T", 1, 4),
+      Key('y', "Y", 1, 5), Key('u', "U", 1, 6), Key('i', "I", 1, 7), Key('o', "O", 1, 8), Key('p', "P", 1, 9),
+      Key('a', "A", 2, 0), Key('s', "S", 2, 1), Key('d', "D", 2, 2), Key('f', "F", 2, 3), Key('g', "G", 2, 4),
+      Key('h', "H", 2, 5), Key('j', "J", 2, 6), Key('k', "K", 2, 7), Key('l', "L", 2, 8), Key(';', ";", 2, 9),
+      Key('z', "Z", 3, 0), Key('x', "X", 3, 1), Key('c', "C", 3, 2), Key('v', "V", 3, 3), Key('b', "B", 3, 4),
+      Key('n', "N", 3, 5), Key('m', "M", 3, 6), Key(',', ",", 3, 7), Key('.', ".", 3, 8), Key('/', "/", 3, 9),
+   };
+   layout.colColors = {
+      rgb(238,  52,  66), rgb(249, 166,  28), rgb(112, 194, 122), rgb(  2, 174, 236), rgb(  2, 174, 236),
+      rgb( 89, 134, 193), rgb( 89, 134, 193), rgb(151, 214, 245), rgb(255, 233, 160), rgb(191, 225, 192),
+   };
+   layout.images = {
+      "images/kb_positioning.png",
+      "images/kb_home_row.png",
+      "images/kb_letters.png",
+      "images/kb_numbers.png",
+   };
+   return layout;
+}
+
+KeyboardLayout KeyboardLayout::load(const std::string& path)
+{
+   std::ifstream ifs(path);
+   if (!ifs) {
+      throw std::runtime_error("cannot open keyboard layout " + path);
+   }
+
+   auto layout = qwerty();
+   layout.name = path;
+   layout.keys.clear();
+
+   std::set<int> codes;
+   std::string line;
+   for (auto lineNb = 1; std::getline(ifs, line); ++lineNb) {
+      auto fail = [&](const std::string& what) {
+         std::ostringstream message;
+         message << path << ":" << lineNb << ": " << what;
+         throw std::runtime_error(message.str());
+      };
+
+      std::istringstream iss(line);
+      std::string directive;
+      if (!(iss >> directive) || directive[0] == '#') {
+         continue;
+      }
+
+      if (directive == "name") {
+         std::getline(iss >> std::ws, layout.name);
+      }
+      else if (directive == "geometry") {
+         auto& rGeometry = layout.geometry;
+         if (!(iss >> rGeometry.origin.x >> rGeometry.origin.y >> rGeometry.colPitch >> rGeometry.rowPitch >> rGeometry.rowStagger)) {
+            fail("expected: geometry <origin x> <origin y> <column pitch> <row pitch> <row stagger>");
+         }
+      }
+      else if (directive == "color") {
+         int col, r, g, b;
+         if (!(iss >> col >> r >> g >> b) || col < 0 || col >= KeyboardModel::MAX_KEYS) {
+            fail("expected: color <column> <red> <green> <blue>");
+         }
+         if (col >= static_cast<int>(layout.colColors.size())) {
+            layout.colColors.resize(col + 1, ci::Color(0, 0, 0));
+         }
+         layout.colColors[col] = rgb(r, g, b);
+      }
+      else if (directive == "image") {
+         std::string skillName, image;
+         iss >> skillName;
+         std::getline(iss >> std::ws, image);
+         const auto it = std::find(std::begin(SKILL_NAMES), std::end(SKILL_NAMES), skillName);
+         if (it == std::end(SKILL_NAMES) || image.empty()) {
+            fail("expected: image <positioning|home_row|letters|numbers> <path>");
+         }
+         layout.images[it - std::begin(SKILL_NAMES)] = image;
+      }
+      else if (directive == "key") {
+         Key key;
+         std::string code;
+         if (!(iss >> key.row >> key.col >> code >> key.c) || key.row < 0 || key.col < 0) {
+            fail("expected: key <row> <column> <code> <label>");
+         }
+         key.code = (code.size() == 1) ? static_cast<unsigned char>(code[0]) : std::atoi(code.c_str());
+         if (key.code <= 0 || key.code >= KeyboardModel::NB_KEY_CODES) {
+            fail("bad key code " + code);
+         }
+         if (!codes.insert(key.code).second) {
+            fail("key code " + code + " is already in the layout");
+         }
+         if (layout.keys.size() == KeyboardModel::MAX_KEYS) {
+            fail("too many keys");
+         }
+         layout.keys.push_back(key);
+      }
+      else {
+         fail("unknown directive " + directive);
+      }
+   }
+
+   if (layout.keys.empty()) {
+      throw std::runtime_error("no keys in keyboard layout " + path);
+   }
+
+   return layout;
+}
+
+const ci::Color& KeyboardLayout::getColColor(int col) const
+{
+   static const ci::Color BLACK(0, 0, 0);
+   return (0 <= col && col < static_cast<int>(colColors.size())) ? colColors[col] : BLACK;
+}
+
+const std::string& KeyboardLayout::getImage(Skill skill) const
+{
+   return images[static_cast<int>(skill)];
+}
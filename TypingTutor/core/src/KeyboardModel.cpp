@@ -0,0 +1,184 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "KeyboardModel.h"
+#include "BitOps.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace ci;
+
+const int KeyboardModel::KEY_UNKNOWN = 0;
+const int KeyboardModel::NO_SLOT = -1;
+
+KeyboardModel::KeyboardModel(const KeyboardLayout& layout)
+{
+   setLayout(layout);
+}
+
+void KeyboardModel::setLayout(const KeyboardLayout& layout)
+{
+   assert(layout.keys.size() <= MAX_KEYS);
+
+   mLayout = layout;
+
+   VKey keys;
+   for (const auto& rKey : layout.keys) {
+      keys.emplace_back(rKey.code, rKey.c, rKey.row, rKey.col);
+   }
+
+   // slots follow the key codes, the order random picks were always made in
+   std::sort(keys.begin(), keys.end(), [](const Key& a, const Key& b){ return a.code < b.code; });
+
+   mKeys = std::move(keys);
+   mSlots.assign(NB_KEY_CODES, NO_SLOT);
+   mCenters.clear();
+   mRects.assign(mKeys.size(), Rectf());
+   mRowMasks.clear();
+   mColMasks.clear();
+   mEnabledMask = 0;
+   mSelectedMask = 0;
+   mWeights.assign(mKeys.size(), 1.0);
+   mSampler.reset(static_cast<int>(mKeys.size()));
+
+   for (size_t slot = 0; slot < mKeys.size(); ++slot) {
+      const auto& rKey = mKeys[slot];
+      assert(0 < rKey.code && rKey.code < NB_KEY_CODES);
+      mSlots[rKey.code] = static_cast<int>(slot);
+
+      const auto& rGeometry = layout.geometry;
+      const auto x = rKey.row * rGeometry.rowStagger + rKey.col * rGeometry.colPitch;
+      const auto y = rKey.row * rGeometry.rowPitch;
+      mCenters.push_back(rGeometry.origin + vec2(x, y));
+      updateRect(static_cast<int>(slot));
+
+      if (rKey.row >= static_cast<int>(mRowMasks.size())) { mRowMasks.resize(rKey.row + 1, 0); }
+      if (rKey.col >= static_cast<int>(mColMasks.size())) { mColMasks.resize(rKey.col + 1, 0); }
+      mRowMasks[rKey.row] |= Mask(1) << slot;
+      mColMasks[rKey.col] |= Mask(1) << slot;
+   }
+}
+
+int KeyboardModel::randSelectKey(Rand& rand) const
+{
+   const auto availableMask = getAvailableMask();
+   const auto nbAvailableKeys = popCount(availableMask);
+   if (nbAvailableKeys == 0) {
+      return KEY_UNKNOWN;
+   }
+
+   const auto slot = mWeightedFlag ?
+      mSampler.sample(rand.nextFloat() * mSampler.getTotal()) :
+      selectBit(availableMask, rand.nextInt(nbAvailableKeys));
+   return (slot >= 0) ? mKeys[slot].code : KEY_UNKNOWN;
+}
+
+void KeyboardModel::setWeighted(bool weightedFlag)
+{
+   mWeightedFlag = weightedFlag;
+   if (mWeightedFlag) {
+      rebuildSampler();
+   }
+}
+
+void KeyboardModel::setKeyWeight(int keyCode, double weight)
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT && weight > 0.0);
+
+   mWeights[slot] = weight;
+   if (mWeightedFlag) {
+      updateSampler(slot);
+   }
+}
+
+void KeyboardModel::updateSampler(int slot)
+{
+   const auto availableFlag = ((getAvailableMask() >> slot) & 1) != 0;
+   mSampler.setWeight(slot, availableFlag ? mWeights[slot] : 0.0);
+}
+
+void KeyboardModel::rebuildSampler()
+{
+   std::vector<double> weights(mWeights.size(), 0.0);
+   const auto availableMask = getAvailableMask();
+   for (size_t slot = 0; slot < weights.size(); ++slot) {
+      if ((availableMask >> slot) & 1) {
+         weights[slot] = mWeights[slot];
+      }
+   }
+   mSampler.rebuild(weights);
+}
+
+void KeyboardModel::updateRect(int slot)
+{
+   Rectf rect(vec2(0), mKeys[slot].size);
+   rect.offsetCenterTo(mTopLeft + mCenters[slot]);
+   mRects[slot] = rect;
+}
+
+void KeyboardModel::setKeySize(int keyCode, const vec2& size)
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT);
+
+   mKeys[slot].size = size;
+   updateRect(slot);
+}
+
+void KeyboardModel::setTopLeft(const vec2& topLeft)
+{
+   if (topLeft == mTopLeft) {
+      return; // the app sets it every frame
+   }
+
+   mTopLeft = topLeft;
+   for (auto slot = 0; slot < getNbSlots(); ++slot) {
+      updateRect(slot);
+   }
+}
+
+void KeyboardModel::selectKey(int keyCode)
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT);
+
+   mSelectedMask |= Mask(1) << slot;
+   if (mWeightedFlag) {
+      updateSampler(slot);
+   }
+}
+
+void KeyboardModel::deselectKey(int keyCode)
+{
+   const auto slot = getSlot(keyCode);
+   assert(slot != NO_SLOT);
+
+   mSelectedMask &= ~(Mask(1) << slot);
+   if (mWeightedFlag) {
+      updateSampler(slot);
+   }
+}
@@ -0,0 +1,214 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "MappedFile.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path, Mode mode) :
+mPath(path),
+mMode(mode)
+{
+   const auto readOnlyFlag = (mMode == Mode::ReadOnly);
+   mFile = CreateFileA(path.c_str(),
+      readOnlyFlag ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE,
+      readOnlyFlag ? FILE_SHARE_READ | FILE_SHARE_WRITE : FILE_SHARE_READ,
+      nullptr, readOnlyFlag ? OPEN_EXISTING : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (mFile == INVALID_HANDLE_VALUE) {
+      mFile = nullptr;
+      throw std::runtime_error("cannot open " + path);
+   }
+
+   LARGE_INTEGER size;
+   GetFileSizeEx(mFile, &size);
+   mSize = static_cast<size_t>(size.QuadPart);
+   map();
+}
+
+MappedFile::~MappedFile()
+{
+   unmap();
+   CloseHandle(mFile);
+}
+
+void MappedFile::map()
+{
+   if (mSize == 0) {
+      return; // an empty file cannot be mapped
+   }
+
+   const auto readOnlyFlag = (mMode == Mode::ReadOnly);
+   mMapping = CreateFileMappingA(mFile, nullptr, readOnlyFlag ? PAGE_READONLY : PAGE_READWRITE, 0, 0, nullptr);
+   if (mMapping != nullptr) {
+      mData = static_cast<uint8_t*>(MapViewOfFile(mMapping, readOnlyFlag ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, mSize));
+   }
+   if (mData == nullptr) {
+      throw std::runtime_error("cannot map " + mPath);
+   }
+}
+
+void MappedFile::unmap()
+{
+   if (mData != nullptr) {
+      UnmapViewOfFile(mData);
+      mData = nullptr;
+   }
+   if (mMapping != nullptr) {
+      CloseHandle(mMapping);
+      mMapping = nullptr;
+   }
+}
+
+void MappedFile::resize(size_t size)
+{
+   assert(mMode == Mode::ReadWrite);
+   unmap();
+
+   // unlike SetEndOfFile, this leaves the file pointer alone for writeThrough()
+   FILE_END_OF_FILE_INFO info;
+   info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+   if (!SetFileInformationByHandle(mFile, FileEndOfFileInfo, &info, sizeof(info))) {
+      map(); // the file keeps its size and its mapping
+      throw std::runtime_error("cannot resize " + mPath);
+   }
+   mSize = size;
+   map();
+}
+
+void MappedFile::writeThrough(size_t offset, const uint8_t* pBytes, size_t length)
+{
+   assert(mMode == Mode::ReadWrite);
+   if (length == 0) {
+      return;
+   }
+
+   // the file cache holds the pages of the mapping; the write lands in them
+   OVERLAPPED overlapped = {};
+   overlapped.Offset = static_cast<DWORD>(offset);
+   overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+   DWORD nbWritten = 0;
+   if (!WriteFile(mFile, pBytes, static_cast<DWORD>(length), &nbWritten, &overlapped) || nbWritten != length) {
+      throw std::runtime_error("cannot write " + mPath);
+   }
+   if (!FlushFileBuffers(mFile)) {
+      throw std::runtime_error("cannot flush " + mPath);
+   }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path, Mode mode) :
+mPath(path),
+mMode(mode)
+{
+   mFile = (mMode == Mode::ReadOnly) ? open(path.c_str(), O_RDONLY) : open(path.c_str(), O_RDWR | O_CREAT, 0644);
+   if (mFile < 0) {
+      throw std::runtime_error("cannot open " + path);
+   }
+
+   struct stat st;
+   fstat(mFile, &st);
+   mSize = static_cast<size_t>(st.st_size);
+   map();
+}
+
+MappedFile::~MappedFile()
+{
+   unmap();
+   close(mFile);
+}
+
+void MappedFile::map()
+{
+   if (mSize == 0) {
+      return; // an empty file cannot be mapped
+   }
+
+   const auto protection = (mMode == Mode::ReadOnly) ? PROT_READ : PROT_READ | PROT_WRITE;
+   const auto pData = mmap(nullptr, mSize, protection, MAP_SHARED, mFile, 0);
+   if (pData == MAP_FAILED) {
+      throw std::runtime_error("cannot map " + mPath);
+   }
+   mData = static_cast<uint8_t*>(pData);
+}
+
+void MappedFile::unmap()
+{
+   if (mData != nullptr) {
+      munmap(mData, mSize);
+      mData = nullptr;
+   }
+}
+
+void MappedFile::resize(size_t size)
+{
+   assert(mMode == Mode::ReadWrite);
+   unmap();
+
+   if (ftruncate(mFile, static_cast<off_t>(size)) != 0) {
+      map(); // the file keeps its size and its mapping
+      throw std::runtime_error("cannot resize " + mPath);
+   }
+   mSize = size;
+   map();
+}
+
+void MappedFile::writeThrough(size_t offset, const uint8_t* pBytes, size_t length)
+{
+   assert(mMode == Mode::ReadWrite);
+   if (length == 0) {
+      return;
+   }
+
+   // the page cache holds the pages of the mapping; the write lands in them
+   while (length > 0) {
+      const auto nbWritten = pwrite(mFile, pBytes, length, static_cast<off_t>(offset));
+      if (nbWritten <= 0) {
+         throw std::runtime_error("cannot write " + mPath);
+      }
+      pBytes += nbWritten;
+      offset += nbWritten;
+      length -= nbWritten;
+   }
+   if (fdatasync(mFile) != 0) {
+      throw std::runtime_error("cannot flush " + mPath);
+   }
+}
+
+#endif
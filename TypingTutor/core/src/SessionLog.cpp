@@ -0,0 +1,245 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "SessionLog.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// File layout, in the byte order of the machine that wrote it: a 16 byte
+// header, "TTS1" then the record size as a u32 and 8 zero bytes, then the
+// records. Past the last record, up to the end of the chunk, the file is
+// zeros.
+
+namespace {
+   const char MAGIC[4] = { 'T', 'T', 'S', '1' };
+}
+
+const uint16_t SessionRecord::LAST_PIECE = 0x8000;
+
+const size_t SessionLog::HEADER_SIZE = 16;
+const size_t SessionLog::CHUNK_SIZE = 256 * 1024;
+const double SessionLog::FLUSH_PERIOD = 1.0;
+
+SessionLog::SessionLog(const std::string& path, const ErrorCallback& onError) :
+mPath(path),
+mOnError(onError),
+mFile(path, MappedFile::Mode::ReadWrite)
+{
+   if (mFile.size() == 0) {
+      mFile.resize(HEADER_SIZE + CHUNK_SIZE);
+      const uint32_t recordSize = sizeof(SessionRecord);
+      std::memcpy(mFile.data(), MAGIC, sizeof(MAGIC));
+      std::memcpy(mFile.data() + sizeof(MAGIC), &recordSize, sizeof(recordSize));
+   }
+   else if (mFile.size() < HEADER_SIZE || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), mFile.data())) {
+      throw std::runtime_error("not a session log: " + path);
+   }
+
+   // the records end at the first blank or torn one
+   const auto pRecords = mFile.data() + HEADER_SIZE;
+   const auto nbSlots = static_cast<int>((mFile.size() - HEADER_SIZE) / sizeof(SessionRecord));
+   auto nbRecords = 0;
+   SessionRecord record;
+   for (; nbRecords < nbSlots; ++nbRecords) {
+      std::memcpy(&record, pRecords + nbRecords * sizeof(SessionRecord), sizeof(record));
+      if (!isValid(record)) {
+         break;
+      }
+      mNextSession = record.session + 1;
+   }
+
+   // a torn record may be followed by stale ones; they must not come back
+   const auto end = nbRecords * sizeof(SessionRecord);
+   std::fill(pRecords + end, mFile.data() + mFile.size(), static_cast<uint8_t>(0));
+
+   mNbRecords = nbRecords;
+   mNbFlushed = nbRecords;
+   mThread = std::thread(&SessionLog::work, this);
+}
+
+SessionLog::~SessionLog()
+{
+   writeBacklog();
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStopFlag = true;
+   }
+   mCondition.notify_all();
+   mThread.join();
+
+   // a reader may have let go of the file since; one last try at the grow,
+   // then at the write of whatever is not on the disk yet
+   if (!writeBacklog() && mOnError) {
+      mOnError(std::to_string(mBacklog.size()) + " records lost: " + mPath + " cannot grow");
+   }
+   {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mFlushErrorFlag = false;
+      flush(&lock);
+   }
+
+   try {
+      mFile.resize(HEADER_SIZE + mNbRecords * sizeof(SessionRecord));
+   }
+   catch (std::exception&) {
+      ; // the zeros past the records are skipped when the log is opened
+   }
+}
+
+uint32_t SessionLog::beginSession()
+{
+   return mNextSession++;
+}
+
+void SessionLog::append(SessionRecord record)
+{
+   record.check = computeCheck(record);
+   mBacklog.push_back(record);
+   writeBacklog();
+}
+
+bool SessionLog::writeBacklog()
+{
+   auto nbRecords = mNbRecords.load(std::memory_order_relaxed);
+   const auto end = HEADER_SIZE + (nbRecords + mBacklog.size()) * sizeof(SessionRecord);
+   if (end > mFile.size()) {
+      // moves the mapping; the flush thread must not be using it
+      std::lock_guard<std::mutex> lock(mMutex);
+      const auto nbChunks = (end - mFile.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+      try {
+         mFile.resize(mFile.size() + nbChunks * CHUNK_SIZE);
+      }
+      catch (std::exception&) {
+         return false; // the records stay in the backlog until the file grows
+      }
+   }
+
+   for (const auto& rRecord : mBacklog) {
+      std::memcpy(mFile.data() + HEADER_SIZE + nbRecords * sizeof(SessionRecord), &rRecord, sizeof(rRecord));
+      ++nbRecords;
+   }
+   mBacklog.clear();
+   mNbRecords.store(nbRecords, std::memory_order_release);
+   return true;
+}
+
+void SessionLog::flush(std::unique_lock<std::mutex>* pLock)
+{
+   // the mapping only stays put under the lock; the disk is waited on without it
+   const auto nbRecords = mNbRecords.load(std::memory_order_acquire);
+   const auto offset = HEADER_SIZE + mNbFlushed * sizeof(SessionRecord);
+   const auto end = HEADER_SIZE + nbRecords * sizeof(SessionRecord);
+   mFlushBytes.assign(mFile.data() + offset, mFile.data() + end);
+   pLock->unlock();
+
+   try {
+      mFile.writeThrough(offset, mFlushBytes.data(), mFlushBytes.size());
+      mNbFlushed = nbRecords;
+      mFlushErrorFlag = false;
+   }
+   catch (std::exception& exc) {
+      // the records stay unflushed and go out with the next flush; the
+      // failure is reported once until a flush succeeds
+      if (!mFlushErrorFlag && mOnError) {
+         mOnError(std::string(exc.what()) + ", " + std::to_string(nbRecords - mNbFlushed) + " records not on the disk");
+      }
+      mFlushErrorFlag = true;
+   }
+
+   pLock->lock();
+}
+
+void SessionLog::work()
+{
+   std::unique_lock<std::mutex> lock(mMutex);
+   while (true) {
+      const auto stopFlag = mCondition.wait_for(lock, std::chrono::duration<double>(FLUSH_PERIOD),
+         [this]{ return mStopFlag; });
+      flush(&lock);
+      if (stopFlag) {
+         return;
+      }
+   }
+}
+
+uint8_t SessionLog::computeCheck(const SessionRecord& record)
+{
+   auto copy = record;
+   copy.check = 0;
+   uint8_t bytes[sizeof(SessionRecord)];
+   std::memcpy(bytes, &copy, sizeof(bytes));
+
+   // never zero for a blank record
+   uint8_t check = 0xA5;
+   for (const auto byte : bytes) {
+      check = static_cast<uint8_t>((check << 1 | check >> 7) ^ byte);
+   }
+   return check;
+}
+
+bool SessionLog::isValid(const SessionRecord& record)
+{
+   return (record.type > SessionRecord::None && record.type < SessionRecord::Last &&
+      record.check == computeCheck(record));
+}
+
+const SessionRecord* SessionLog::getRecords(const MappedFile& file, int* pNbRecords)
+{
+   assert(pNbRecords != nullptr);
+
+   if (file.size() < HEADER_SIZE || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), file.data())) {
+      throw std::runtime_error("not a session log");
+   }
+
+   // the mapping is page aligned and the header keeps the records aligned
+   *pNbRecords = static_cast<int>((file.size() - HEADER_SIZE) / sizeof(SessionRecord));
+   return reinterpret_cast<const SessionRecord*>(file.data() + HEADER_SIZE);
+}
+
+SessionLog::VRecord SessionLog::load(const std::string& path)
+{
+   std::ifstream ifs(path, std::ios::binary);
+   if (!ifs) {
+      throw std::runtime_error("cannot open session log " + path);
+   }
+
+   char header[HEADER_SIZE] = {};
+   ifs.read(header, sizeof(header));
+   if (!ifs || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), header)) {
+      throw std::runtime_error("not a session log: " + path);
+   }
+
+   VRecord records;
+   SessionRecord record;
+   while (ifs.read(reinterpret_cast<char*>(&record), sizeof(record)) && isValid(record)) {
+      records.push_back(record);
+   }
+   return records;
+}
@@ -0,0 +1,115 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "SessionRecorder.h"
+
+#include <cassert>
+#include <cstring>
+#include <ctime>
+
+SessionRecorder::SessionRecorder(GameCore* pCore, SessionLog* pLog) :
+mCorePtr(pCore),
+mLogPtr(pLog)
+{
+   assert(mCorePtr != nullptr);
+   assert(mLogPtr != nullptr);
+
+   mSession = mLogPtr->beginSession();
+   mSpawnSteps.resize(mCorePtr->getKeyboard().getNbSlots(), 0);
+   mCorePtr->addObserver(this);
+
+   SessionRecord record = {};
+   record.session = mSession;
+   record.step = static_cast<uint32_t>(std::time(nullptr));
+   record.value = static_cast<float>(mCorePtr->getDuration());
+   record.code = static_cast<uint16_t>(mCorePtr->getRules().skill);
+   record.type = SessionRecord::Start;
+   mLogPtr->append(record);
+
+   // tt_stats needs it to tell the finger of each key
+   const auto& rName = mCorePtr->getKeyboard().getLayout().name;
+   for (size_t offset = 0; offset < rName.size(); offset += 8) {
+      char piece[8] = {};
+      rName.copy(piece, sizeof(piece), offset);
+      record.step = 0;
+      record.value = 0.0f;
+      std::memcpy(&record.step, piece, 4);
+      std::memcpy(&record.value, piece + 4, 4);
+      record.code = static_cast<uint16_t>(offset);
+      if (offset + 8 >= rName.size()) {
+         record.code |= SessionRecord::LAST_PIECE;
+      }
+      record.type = SessionRecord::Layout;
+      mLogPtr->append(record);
+   }
+}
+
+void SessionRecorder::append(SessionRecord::Type type, int keyCode, double value)
+{
+   SessionRecord record = {};
+   record.session = mSession;
+   record.step = mCorePtr->getStepCount();
+   record.value = static_cast<float>(value);
+   record.code = static_cast<uint16_t>(keyCode);
+   record.type = type;
+   mLogPtr->append(record);
+}
+
+double SessionRecorder::getTimeSinceSpawn(int keyCode) const
+{
+   const auto slot = mCorePtr->getKeyboard().getSlot(keyCode);
+   const auto nbSteps = mCorePtr->getStepCount() - mSpawnSteps[slot];
+   return nbSteps * GameCore::TIME_STEP;
+}
+
+void SessionRecorder::onToonSpawned(int keyCode)
+{
+   mSpawnSteps[mCorePtr->getKeyboard().getSlot(keyCode)] = mCorePtr->getStepCount();
+}
+
+void SessionRecorder::onToonHurled(int keyCode, double /*score*/)
+{
+   append(SessionRecord::Hit, keyCode, getTimeSinceSpawn(keyCode));
+}
+
+void SessionRecorder::onToonEscaped(int keyCode)
+{
+   append(SessionRecord::Escape, keyCode, getTimeSinceSpawn(keyCode));
+}
+
+void SessionRecorder::onWrongKey(int keyCode)
+{
+   append(SessionRecord::Miss, keyCode, 0.0);
+}
+
+void SessionRecorder::onStreakBonus(double bonus)
+{
+   append(SessionRecord::Streak, 0, bonus);
+}
+
+void SessionRecorder::finish()
+{
+   append(SessionRecord::End, 0, mCorePtr->getScore());
+}
@@ -0,0 +1,232 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "ToonPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace ci;
+
+const ToonPool::Handle ToonPool::NO_TOON = -1;
+const double ToonPool::SPAWNING_DURATION = 0.15;
+const double ToonPool::ESCAPING_DURATION = 0.1;
+const double ToonPool::INGAME_DURATION = 5.0;
+const double ToonPool::SHAKING_DURATION = 2.0;
+const double ToonPool::GRAVITY = 1000.0;
+
+ToonPool::ToonPool(double reducedTimeCoef)
+{
+   mCanEscapeFlag = (reducedTimeCoef > 0.0);
+   mIngameDuration = INGAME_DURATION;
+   mShakingDuration = SHAKING_DURATION;
+   if (mCanEscapeFlag) { 
+      mIngameDuration *= reducedTimeCoef; 
+      mShakingDuration *= reducedTimeCoef;
+   }
+}
+
+ToonPool::Handle ToonPool::add(const vec2& size)
+{
+   const auto toon = getSize();
+
+   mStates.push_back(State::Available);
+   mTimes.push_back(0.0);
+   mScores.push_back(0.0);
+   mAngles.push_back(0.0);
+   mSnapFlags.push_back(true);
+   mRects.push_back(Rectf());
+   mPrevRects.push_back(Rectf());
+   mSizes.push_back(size);
+   mAvailable.push_back(toon);
+
+   return toon;
+}
+
+ToonPool::Handle ToonPool::spawnAvailable(int n)
+{
+   assert(0 <= n && n < getNbAvailable());
+
+   // the last of the free list fills the hole
+   const auto toon = mAvailable[n];
+   mAvailable[n] = mAvailable.back();
+   mAvailable.pop_back();
+
+   setState(toon, State::Spawning);
+   mSnapFlags[toon] = true;
+   return toon;
+}
+
+void ToonPool::setState(Handle toon, State state)
+{
+   if (mStates[toon] == State::InGame) { --mNbInGame; }
+   if (state == State::InGame) { ++mNbInGame; }
+
+   mStates[toon] = state;
+   mTimes[toon] = 0.0;
+}
+
+void ToonPool::retire(Handle toon)
+{
+   setState(toon, State::Available);
+   mScores[toon] = 0.0;
+   mAngles[toon] = 0.0;
+   mAvailable.push_back(toon);
+}
+
+bool ToonPool::update(Handle toon, double dt, const Rectf& keyRect, const Rectf& bounds, Rand& rand)
+{
+   auto escapedFlag = false;
+
+   mPrevRects[toon] = mRects[toon];
+   mTimes[toon] += dt;
+
+   const auto time = mTimes[toon];
+   switch (mStates[toon]) {
+      case State::Spawning: {
+         if (time > SPAWNING_DURATION) {
+            setState(toon, State::InGame);
+         }
+      } break;
+
+      case State::InGame: {
+         const auto timeRemaining = mIngameDuration - time;
+         if (mCanEscapeFlag && timeRemaining < 0.0) {
+            setState(toon, State::Escaping);
+         }
+      } break;
+
+      case State::Escaping: {
+         if (time > ESCAPING_DURATION) {
+            retire(toon);
+            escapedFlag = true;
+         }
+      } break;
+
+      default: break;
+   }
+
+   if (mStates[toon] == State::Available) {
+      return escapedFlag; // nothing more to simulate
+   }
+
+   mRects[toon] = computeRect(toon, keyRect, rand);
+
+   if (mSnapFlags[toon]) {
+      mSnapFlags[toon] = false;
+      mPrevRects[toon] = mRects[toon];
+   }
+
+   if (!mRects[toon].intersects(bounds)) {
+      retire(toon);
+   }
+
+   return escapedFlag;
+}
+
+Rectf ToonPool::computeRect(Handle toon, const Rectf& keyRect, Rand& rand) const
+{
+   Rectf toonRect(vec2(0), mSizes[toon]);
+
+   const auto keyCenter = keyRect.getCenter();
+   const auto startingPos = keyCenter + vec2(0, 0.5 * (keyRect.getHeight() + toonRect.getHeight()));
+   const auto time = mTimes[toon];
+
+   switch (mStates[toon]) {
+
+      case State::Available: {
+         ; // nothing to place
+      } break;
+
+      case State::Spawning: {
+         toonRect.offsetCenterTo(startingPos);
+         const auto scale = 1.0 - std::max((SPAWNING_DURATION - time) / SPAWNING_DURATION, 0.0);
+         toonRect.scaleCentered(static_cast<float>(scale));
+      } break;
+
+      case State::InGame: {
+         auto offset = vec2(0, 0);
+         if (mCanEscapeFlag) {
+            const auto timeRemaining = mIngameDuration - time;
+            if (0.0 < timeRemaining && timeRemaining < mShakingDuration) {
+               const auto d = rand.nextFloat(5.0f);
+               offset = d * rand.nextVec2();
+            }
+         }
+         toonRect.offsetCenterTo(startingPos + offset);
+      } break;
+
+      case State::Hurled: {
+         // see: https://fr.wikipedia.org/wiki/Balistique
+         // zmax = ((vx0 * sin(alpha))^2) / (2g) + z0
+         // v0 = sqrt(2g * (zmax - z0)) / sin(alpha)
+         const auto zmax = startingPos.y + 0.5 * toonRect.getHeight() + 10;
+         const auto g = GRAVITY;
+         const auto alpha = mAngles[toon] * 3.14159265359 / 180.0;
+         const auto v0 = std::sqrt(2 * g * zmax) / std::sin(alpha);
+         const auto attenuation = 0.1 * mScores[toon];
+         const auto velocity = v0 * attenuation * attenuation;
+         // x(t) = vx0 * t + x0
+         // z(t) = -0.5 * g * t^2 + vz0 * t + z0
+         const auto t = time;
+         const auto x0 = startingPos.x;
+         const auto vx0 = velocity * std::cos(alpha);
+         const auto x = vx0 * t + x0;
+         const auto z0 = startingPos.y;
+         const auto vz0 = velocity * std::sin(alpha);
+         const auto z = 0.5 * g * t * t - vz0 * t + z0;
+         const auto currentPos = vec2(x, z);
+         toonRect.offsetCenterTo(currentPos);
+      } break;
+
+      case State::Escaping: {
+         toonRect.offsetCenterTo(startingPos);
+         const auto t = std::min(time / ESCAPING_DURATION, 1.0);
+         const auto scale = 1.0 - t;
+         toonRect.scaleCentered(static_cast<float>(scale));
+      } break;
+   }
+
+   return toonRect;
+}
+
+Rectf ToonPool::getRect(Handle toon, double alpha) const
+{
+   // blend the last two simulation steps for the time elapsed since the last one
+   const auto a = static_cast<float>(alpha);
+   const auto upperLeft = glm::mix(mPrevRects[toon].getUpperLeft(), mRects[toon].getUpperLeft(), a);
+   const auto lowerRight = glm::mix(mPrevRects[toon].getLowerRight(), mRects[toon].getLowerRight(), a);
+   return Rectf(upperLeft, lowerRight);
+}
+
+double ToonPool::hurl(Handle toon, Rand& rand)
+{
+   const auto time = mTimes[toon];
+   setState(toon, State::Hurled);
+   mAngles[toon] = static_cast<double>(rand.nextFloat(70.0f, 110.0f));
+   mScores[toon] = std::ceil(10.0 * std::max((mIngameDuration - time) / mIngameDuration, 0.0));
+   return mScores[toon];
+}
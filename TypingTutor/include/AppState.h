@@ -30,6 +30,10 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class AppState {
    public:
       virtual void update(TypingTutorInterface* pApp) = 0;
-      virtual void draw(const TypingTutorInterface& rApp) = 0;
+      virtual void draw(TypingTutorInterface& rApp) = 0;
       virtual void keyDown(int code) = 0;
+
+      // what the state puts over the background and keeps until the next
+      // state change or resize; it is painted once into the seat's cached layer
+      virtual void drawStatic(TypingTutorInterface& /*rApp*/) {}
 };
\ No newline at end of file
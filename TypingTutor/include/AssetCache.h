@@ -0,0 +1,85 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "TextureAtlas.h"
+#include "AssetLoader.h"
+#include "VoiceMixerNode.h"
+
+#include "cinder/audio/audio.h"
+#include "cinder/gl/Texture.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct KeyboardLayout;
+
+class AssetCache;
+using AssetCacheRef = std::shared_ptr<AssetCache>;
+
+// Process-wide store of the decoded game assets. The app owns it and hands
+// it to every Game, so starting a new round reuses the textures, the atlas
+// regions and the sound effects loaded by the first one. preload() decodes the
+// game assets of a keyboard layout in the background; whatever is still
+// missing when a Game asks for it is loaded on the spot.
+class AssetCache {
+   public:
+      using VRegion = std::vector<TextureAtlas::RegionRef>;
+
+      ci::gl::TextureRef getTexture(const ci::fs::path& path);
+      const VRegion& getToonRegions();
+      TextureAtlas::RegionRef getKeyGlyph(const std::string& c, const ci::Color& color);
+      int getSound(const ci::fs::path& path, float gain, int priority);
+      const VoiceMixerNodeRef& getMixer();
+      void buildAtlas();
+      void preload(const KeyboardLayout& layout, AssetLoader* pLoader);
+
+   private:
+      using GlyphKey = std::tuple<std::string, float, float, float>;
+      using TextureMap = std::map<ci::fs::path, ci::gl::TextureRef>;
+      using GlyphMap = std::map<GlyphKey, TextureAtlas::RegionRef>;
+      using SoundMap = std::map<ci::fs::path, int>;
+      using BufferMap = std::map<ci::fs::path, ci::audio::BufferRef>;
+      using VSurface = std::vector<ci::Surface>;
+
+      static VSurface loadToonSurfaces();
+
+      void addToonSurfaces(const VSurface& surfaces);
+      ci::audio::BufferRef getBuffer(const ci::fs::path& path);
+
+      bool mToonsLoadedFlag{ false };
+      bool mAtlasDirtyFlag{ false };
+      TextureAtlas mAtlas;
+      VRegion mToonRegions;
+      TextureMap mTextures;
+      GlyphMap mKeyGlyphs;
+      SoundMap mSounds;
+      VoiceMixerNodeRef mMixer;
+      BufferMap mBuffers;
+};
@@ -0,0 +1,82 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs load jobs (file reading, image and audio decoding) on a pool of worker
+// threads. A job returns a finalizer that is run later on the GL thread by
+// update() or flush(), where textures can be uploaded and nodes created.
+class AssetLoader {
+   public:
+      using Finalizer = std::function<void()>;
+      using Job = std::function<Finalizer()>;
+
+      AssetLoader();
+      ~AssetLoader();
+
+      void enqueue(const Job& job);
+      void update(double timeBudget);
+      void flush();
+      bool isDone() const;
+      float getProgress() const;
+
+   private:
+      using VThread = std::vector<std::thread>;
+      using DJob = std::deque<Job>;
+      using DFinalizer = std::deque<Finalizer>;
+
+      void work();
+      bool finalizeOne();
+
+      bool mStopFlag{ false };
+      int mNbRunning{ 0 };
+      int mNbJobs{ 0 };
+      int mNbFinalized{ 0 };
+      VThread mThreads;
+      DJob mJobs;
+      DFinalizer mFinalizers;
+      std::mutex mMutex;
+      std::condition_variable mJobCondition;
+      std::condition_variable mDoneCondition;
+};
+
+inline
+bool AssetLoader::isDone() const
+{
+   return (mNbFinalized == mNbJobs);
+}
+
+inline
+float AssetLoader::getProgress() const
+{
+   return (mNbJobs > 0) ? static_cast<float>(mNbFinalized) / mNbJobs : 1.0f;
+}
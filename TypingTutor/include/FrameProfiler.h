@@ -0,0 +1,137 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/Timer.h"
+#include "cinder/Vector.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TextRenderer;
+
+// CPU time spent in each phase of a frame, kept for the last NB_FRAMES
+// frames. A frame goes into the ring when the next one begins. The profiler
+// is not thread-safe: it is written and read on the main thread only.
+// The HUD shows the min, average and 99th percentile of each phase; dump()
+// writes the frames to a CSV file.
+class FrameProfiler {
+   public:
+      enum class Phase{ 
+         Frame, 
+         Update, 
+         Loader, 
+         StateUpdate, 
+         Draw, 
+         Background, 
+         Keyboard, 
+         Toons, 
+         Hud, 
+         Last 
+      };
+
+      // Adds the time until the end of the scope to a phase of the frame.
+      class Scope {
+         public:
+            Scope(FrameProfiler& rProfiler, Phase phase);
+            ~Scope();
+
+         private:
+            FrameProfiler& mProfiler;
+            Phase mPhase;
+            ci::Timer mTimer;
+      };
+
+      struct Stats {
+         double min{ 0.0 };
+         double avg{ 0.0 };
+         double p99{ 0.0 };
+      };
+
+      static const int NB_FRAMES;
+
+      FrameProfiler();
+
+      void beginFrame();
+      void add(Phase phase, double seconds);
+      Stats computeStats(Phase phase) const;
+      void toggleHud();
+      bool isHudVisible() const;
+      void drawHud(TextRenderer& rText, const ci::vec2& pos);
+      void dump(const std::string& path) const;
+
+   private:
+      static const int NB_PHASES = static_cast<int>(Phase::Last);
+      static const double HUD_REFRESH_PERIOD;
+      static const char* const PHASE_NAMES[];
+
+      using Frame = std::array<float, NB_PHASES>;
+      using VFrame = std::vector<Frame>;
+
+      int copyFrames(VFrame* pFrames) const;
+
+      bool mHudVisibleFlag{ false };
+      VFrame mFrames;
+      uint32_t mNbFramesDone{ 0 };
+      Frame mCurrentFrame;
+      ci::Timer mFrameTimer;
+      ci::Timer mHudTimer{ true };
+      std::vector<std::string> mHudLines;
+};
+
+inline
+FrameProfiler::Scope::Scope(FrameProfiler& rProfiler, Phase phase) :
+mProfiler(rProfiler),
+mPhase(phase),
+mTimer(true)
+{
+}
+
+inline
+FrameProfiler::Scope::~Scope()
+{
+   mProfiler.add(mPhase, mTimer.getSeconds());
+}
+
+inline
+void FrameProfiler::add(Phase phase, double seconds)
+{
+   mCurrentFrame[static_cast<int>(phase)] += static_cast<float>(1000.0 * seconds);
+}
+
+inline
+void FrameProfiler::toggleHud()
+{
+   mHudVisibleFlag = !mHudVisibleFlag;
+}
+
+inline
+bool FrameProfiler::isHudVisible() const
+{
+   return mHudVisibleFlag;
+}
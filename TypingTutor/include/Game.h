@@ -29,88 +29,75 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AppState.h"
 #include "Keyboard.h"
 #include "TimeBar.h"
-#include "Toon.h"
+#include "GameCore.h"
+#include "GameObserver.h"
+#include "GameRecorder.h"
+#include "SessionRecorder.h"
+#include "AssetCache.h"
 
-#include "cinder/audio/audio.h"
-
-class Game : public AppState {
+// A game on screen: drives a GameCore in real time, draws it and plays its
+// sounds as one of its observers. The keys pressed are recorded and the game
+// is saved in the replays folder when it is over; with a session log, what
+// happens is also appended to it.
+//
+// A frame is update(), then advance(), then endUpdate(). advance() only steps
+// the simulation and touches nothing outside the game, so the games of
+// several seats can advance at the same time on different threads; the sounds
+// they make are queued and played by endUpdate() on the main thread.
+class Game : public AppState, public GameObserver {
    public:
-      Game(double duration, double gameSpeedCoef);
+      Game(const GameRules& rules, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog);
       virtual ~Game() = 0 {}
 
       virtual void update(TypingTutorInterface* pApp) override;
-      virtual void draw(const TypingTutorInterface& rApp) override;
+      virtual void draw(TypingTutorInterface& rApp) override;
       virtual void keyDown(int code) override;
+      virtual void drawStatic(TypingTutorInterface& rApp) override;
+      void advance();
+      void endUpdate();
 
-   protected:
-      struct StreakBonus {
-         std::string bonus;
-         ci::vec2 pos;
-         double expiration;
-      };
-
-      enum class GameState{ Preset, Playing, GameOver };
+      virtual void onToonSpawned(int keyCode) override;
+      virtual void onToonHurled(int keyCode, double score) override;
+      virtual void onToonEscaped(int keyCode) override;
+      virtual void onWrongKey(int keyCode) override;
+      virtual void onStreakBonus(double bonus) override;
 
+   protected:
       static const ci::ColorA TRANSPARENT_BLACK;
       static const ci::Colorf GREEN;
       static const ci::Colorf WHITE;
-      static const double STREAK_BONUS_EXPIRATION;
-
-      using VToon = std::vector<Toon>;
-      using KeyToonPair = std::pair<int, Toon*>;
-      using VKeyToon = std::vector<KeyToonPair>;
-      using VStreakBonus = std::vector<StreakBonus>;
+      static const double MAX_FRAME_TIME;
 
-      double computeFillRatio() const;
+      double getRenderTime() const;
       void loadToons();
-      void updateNextSpawingTime();
-      int countAvailableToons() const;
-      int countInGameToons() const;
-      Toon* randSelectToon();
-      void drawScore(const TypingTutorInterface& rApp) const;
-      void drawStreak(const TypingTutorInterface& rApp) const;
-      void drawGameOver(const TypingTutorInterface& rApp) const;
+      void drawScore(TypingTutorInterface& rApp) const;
+      void drawStreak(TypingTutorInterface& rApp) const;
+      void drawGameOver(TypingTutorInterface& rApp) const;
       void loadSounds();
-      void playBoing(double score);
-      void incStreakCount(int keyCode);
-      void resetStreakCount();
-      void newStreakBonus(double bonus, ci::vec2 pos);
-      
-      void loadSound(const ci::fs::path& path, float gain, ci::audio::Context* ctx,
-         ci::audio::BufferPlayerNodeRef* pPlayerNodeRef, ci::audio::GainNodeRef* pGainNodeRef);
+      void loadSound(const ci::fs::path& path, float gain, int priority, int* pSound);
+      void playSound(int sound);
+      void playPendingSounds();
+      void saveReplay();
 
-      GameState mState{ GameState::Preset };
       bool mKeyEscapeFlag{ false };
-      bool mPerfectGameBonusOnceFlag{ true };
-      bool mPerfectGameFlag{ true };
-      double mDuration{ 0.0 };
-      double mGameSpeedCoef{ 1.0 };
-      double mTimePenalty{ 0.0 };
-      double mSpawningTime{ 3.0 };
-      double mScore{ 0.0 };
-      int mStreakCnt{ 0 };
-      int mStreakCntFloor{ 0 };
-      int mStreakThreshold{ 5 };
-      int mStreakMaxInc{ 10 };
-      int mMaxNbToons{ 1 };
-      ci::Timer mTimer{ true };
+      bool mReplaySavedFlag{ false };
+      bool mScreenshotFlag{ false };
+      double mLastClockTime{ 0.0 };
+      double mAccumulator{ 0.0 };
+      ci::Timer mClock{ true };
+      AssetCacheRef mAssets;
+      GameCore mCore;
+      GameRecorder mRecorder;
+      std::unique_ptr<SessionRecorder> mSessionRecorder;
       Keyboard mKb;
       TimeBar mTimeBar;
-      VToon mToons;
-      VKeyToon mKeyToonPairs;
-      VStreakBonus mStreakBonuses;
-      ci::audio::GainNodeRef mToonGrowGain;
-      ci::audio::GainNodeRef mToonShrinkGain;
-      ci::audio::GainNodeRef mToonBoing1Gain;
-      ci::audio::GainNodeRef mToonBoing2Gain;
-      ci::audio::GainNodeRef mToonBoing3Gain;
-      ci::audio::GainNodeRef mToonBuzzGain;
-      ci::audio::GainNodeRef mStreakBonusGain;
-      ci::audio::BufferPlayerNodeRef mToonGrowPlayerNode;
-      ci::audio::BufferPlayerNodeRef mToonShrinkPlayerNode;
-      ci::audio::BufferPlayerNodeRef mToonBoing1PlayerNode;
-      ci::audio::BufferPlayerNodeRef mToonBoing2PlayerNode;
-      ci::audio::BufferPlayerNodeRef mToonBoing3PlayerNode;
-      ci::audio::BufferPlayerNodeRef mToonBuzzPlayerNode;
-      ci::audio::BufferPlayerNodeRef mStreakBonusPlayerNode;
+      AssetCache::VRegion mToonRegions;
+      std::vector<int> mPendingSounds;
+      int mToonGrowSound{ -1 };
+      int mToonShrinkSound{ -1 };
+      int mToonBoing1Sound{ -1 };
+      int mToonBoing2Sound{ -1 };
+      int mToonBoing3Sound{ -1 };
+      int mToonBuzzSound{ -1 };
+      int mStreakBonusSound{ -1 };
 };
@@ -29,6 +29,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class GameHomeRow : public Game {
    public:
-      GameHomeRow(double duration);
+      GameHomeRow(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog);
       virtual ~GameHomeRow() {}
 };
\ No newline at end of file
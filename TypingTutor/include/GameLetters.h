@@ -29,6 +29,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class GameLetters : public Game {
 public:
-   GameLetters(double duration);
+   GameLetters(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog);
    virtual ~GameLetters() {}
 };
\ No newline at end of file
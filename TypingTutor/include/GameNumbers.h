@@ -29,6 +29,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class GameNumbers : public Game {
 public:
-   GameNumbers(double duration);
+   GameNumbers(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog);
    virtual ~GameNumbers() {}
 };
\ No newline at end of file
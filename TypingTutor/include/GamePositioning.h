@@ -29,6 +29,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class GamePositioning : public Game {
    public:
-      GamePositioning(double duration);
+      GamePositioning(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog);
       virtual ~GamePositioning() {}
 };
\ No newline at end of file
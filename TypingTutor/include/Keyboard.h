@@ -27,95 +27,33 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "cinder/gl/Texture.h"
 #include "TypingTutorInterface.h"
+#include "TextureAtlas.h"
+#include "KeyboardModel.h"
 
-#include <map>
+#include <vector>
 
+class AssetCache;
+
+// Draws the keyboard of a KeyboardModel: the background image and the key
+// caps. It also tells the model where the keys are on screen.
 class Keyboard {
    public:
-      Keyboard();
+      Keyboard(KeyboardModel* pModel);
 
-      void loadImageFile(const ci::fs::path& ImagePath);
-      void draw(const TypingTutorInterface& rApp);
-      void drawKey(int keyCode);
-      void enableRow(int iRow);
-      void enableCol(int iRow);
-      void disableRow(int iCol);
-      void disableCol(int iCol);
-      void selectKey(int keyCode);
-      void deselectKey(int keyCode);
-      int randSelectKey() const;
-      const ci::Rectf getKeyRectf(int key) const;
-      const ci::gl::TextureRef getKeyTexture(int key) const;
+      void setTexture(const ci::gl::TextureRef& texture);
+      void generateTextures(AssetCache* pAssets);
+      void updateLayout(const TypingTutorInterface& rApp);
+      void draw(TypingTutorInterface& rApp);
+      void drawKey(TypingTutorInterface& rApp, int keyCode);
+      const TextureAtlas::RegionRef getKeyRegion(int key) const;
 
    private:
-      struct Key {
-         Key() = default;
-         Key(std::string c_, int row_, int col_, bool enabled_, bool available_) :
-            c(c_), row(row_), col(col_), enabled(enabled_), available(available_) {}
-
-         std::string c;
-         int row{ 0 };
-         int col{ 0 };
-         bool enabled{ false };
-         bool available{ false };
-         ci::gl::TextureRef texture;
-      };
-
-      using KeyMap = std::map<int, Key>;
+      using VRegion = std::vector<TextureAtlas::RegionRef>;
 
-      static ci::Color getColumnColor(int col);
-         
-      template<bool b> void setEnableRow(int iRow);
-      template<bool b> void setEnableCol(int iCol);
-      int countAvailableKeys() const;
-      void generateTextures();
-      void drawAllKeys();
+      void drawAllKeys(TypingTutorInterface& rApp);
 
-      KeyMap mKeyMap;
+      KeyboardModel* mModelPtr{ nullptr };
+      VRegion mRegions; // by key slot
       ci::gl::TextureRef mTexture;
       ci::vec2 mTopLeft;
 };
-
-template<bool b>
-void Keyboard::setEnableRow(int iRow)
-{
-   for (auto& i : mKeyMap) {
-      if (i.second.row == iRow) {
-         i.second.enabled = b;
-      }
-   }
-}
-
-template<bool b>
-void Keyboard::setEnableCol(int iCol)
-{
-   for (auto& i : mKeyMap) {
-      if (i.second.col == iCol) {
-         i.second.enabled = b;
-      }
-   }
-}
-
-inline
-void Keyboard::enableRow(int iRow)
-{
-   setEnableRow<true>(iRow);
-}
-
-inline
-void Keyboard::enableCol(int iCol)
-{
-   setEnableCol<true>(iCol);
-}
-
-inline
-void Keyboard::disableRow(int iRow)
-{
-   setEnableRow<false>(iRow);
-}
-
-inline
-void Keyboard::disableCol(int iCol)
-{
-   setEnableCol<false>(iCol);
-}
@@ -0,0 +1,60 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <functional>
+#include <vector>
+
+// Tells the keyboards plugged into the machine apart, so that each seat of a
+// multi-seat session gets the keys of its own keyboard whichever window has
+// the focus. A keyboard is bound to a seat the first time one of its keys is
+// pressed, to the first seat without a keyboard yet. The keys are handed to
+// the callback while the window messages are dispatched, as the key events
+// of a window are.
+//
+// It reads the raw input of Windows; elsewhere isActive() is false and the
+// keys go to the seat of the focused window.
+class KeyboardRouter {
+   public:
+      using Callback = std::function<void(int seat, int keyCode)>;
+
+      KeyboardRouter(int nbSeats, const Callback& callback);
+      ~KeyboardRouter();
+
+      bool isActive() const;
+      void route(void* device, int keyCode); // from the raw input window
+
+   private:
+      Callback mCallback;
+      std::vector<void*> mDevices; // by seat, the keyboard bound to it
+      void* mWindow{ nullptr };
+};
+
+inline
+bool KeyboardRouter::isActive() const
+{
+   return (mWindow != nullptr);
+}
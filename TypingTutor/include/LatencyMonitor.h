@@ -0,0 +1,86 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/Vector.h"
+
+#include <string>
+#include <vector>
+
+class TextRenderer;
+
+// How long a key takes to show on screen, split in stages:
+//    queue    from the OS receiving the key to keyDown dispatch
+//    wait     from keyDown to the next update
+//    render   from that update to the end of the buffer swap of its frame
+//    total    from the OS to the end of the swap
+// The swap is taken to end when the next frame begins; the time the display
+// then takes to scan the frame out is not seen. Each stage keeps a histogram
+// of 1 ms bins. The OS stamps a key with the system tick, which only moves
+// every 10 to 16 ms, so the queue stage (and the queue part of the total)
+// is that coarse: its samples fall in the 0 ms bin or near a tick.
+class LatencyMonitor {
+   public:
+      enum class Stage{ Queue, Wait, Render, Total, Last };
+
+      struct Stats {
+         int count{ 0 };
+         double p50{ 0.0 };
+         double p99{ 0.0 };
+         double max{ 0.0 };
+      };
+
+      LatencyMonitor();
+
+      void keyDown();
+      void update();
+      void draw();
+      Stats computeStats(Stage stage) const;
+      void drawHud(TextRenderer& rText, const ci::vec2& pos) const;
+      void dump(const std::string& path) const;
+
+   private:
+      struct Key {
+         double arrival;
+         double dispatch;
+         double update;
+      };
+
+      using VKey = std::vector<Key>;
+      using Histogram = std::vector<int>;
+      using VHistogram = std::vector<Histogram>;
+
+      static const int NB_BINS;
+      static const char* const STAGE_NAMES[];
+
+      void addSample(Stage stage, double seconds);
+
+      VKey mDispatchedKeys;
+      VKey mUpdatedKeys;
+      VKey mDrawnKeys;
+      VHistogram mHistograms;
+      std::vector<double> mMaxima;
+};
@@ -0,0 +1,62 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/gl/Fbo.h"
+
+#include <functional>
+
+// A layer of a window that rarely changes (the background, the keyboard),
+// painted once into a framebuffer and then blitted every frame: one textured
+// quad instead of every draw call and every blended pixel of the layer. It is
+// painted again when invalidated or when the window changes size. The
+// framebuffer belongs to the GL context current when the layer is drawn.
+class LayerCache {
+   public:
+      using Painter = std::function<void()>;
+
+      void invalidate();
+      void draw(const ci::ivec2& size, const Painter& paint);
+      int getRenderCount() const;
+
+   private:
+      bool mValidFlag{ false };
+      int mRenderCount{ 0 };
+      ci::gl::FboRef mFbo;
+};
+
+inline
+void LayerCache::invalidate()
+{
+   mValidFlag = false;
+}
+
+// Number of times the layer was painted; once per state change or resize.
+inline
+int LayerCache::getRenderCount() const
+{
+   return mRenderCount;
+}
@@ -33,23 +33,39 @@ class Menu : public AppState {
       virtual ~Menu() = default;
 
       virtual void update(TypingTutorInterface* pApp) override final;
-      virtual void draw(const TypingTutorInterface& rApp) override final;
+      virtual void draw(TypingTutorInterface& rApp) override final;
       virtual void keyDown(int code) override final;
 
+      int getRenderCount() const;
+
    protected:
       using VString = std::vector<std::string>;
+      using VTexture = std::vector<ci::gl::TextureRef>;
 
       static const ci::Colorf GREEN;
       static const ci::Colorf YELLOW;
+      static const float BORDER;
 
       virtual void updateImpl(TypingTutorInterface* pApp) = 0;
-      void addLine(int iOption, ci::TextLayout* pLayout);
+      ci::gl::TextureRef renderLine(const std::string& line, const ci::Colorf& color);
+      void updateTextures();
+      void invalidateLine(int iOption);
 
       bool mKeyEscapeFlag{ false };
       bool mSelectionFlag{ false };
       int mSelectedOption{ 0 };
       int mSavedOption{ 0 };
+      int mRenderCount{ 0 };
       std::string mHeader;
       VString mOptions;
-      ci::gl::TextureRef mMenu;
+      ci::gl::TextureRef mHeaderTexture;
+      VTexture mOptionTextures;
 };
+
+// Number of lines rendered to a texture since construction. The menu lines
+// are only rendered again when the highlighted option moves.
+inline
+int Menu::getRenderCount() const
+{
+   return mRenderCount;
+}
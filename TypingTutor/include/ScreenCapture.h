@@ -0,0 +1,85 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/Area.h"
+#include "cinder/gl/Pbo.h"
+#include "cinder/gl/Sync.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Saves screenshots without stalling the frame. capture() has the GPU copy
+// the back buffer into a pixel buffer object; update() maps it on a later
+// frame, once the copy is done, and a worker thread encodes the PNG file.
+// The files are stem0.png, stem1.png, ...; the first free number is looked
+// up once and counted from there.
+class ScreenCapture {
+   public:
+      ScreenCapture(const std::string& stem);
+      ~ScreenCapture();
+
+      void capture(const ci::Area& area);
+      void update();
+      void flush();
+
+   private:
+      struct Readback {
+         ci::gl::PboRef pbo;
+         ci::gl::SyncRef sync;
+         ci::ivec2 size;
+         std::string path;
+      };
+
+      struct Image {
+         std::vector<uint8_t> pixels; // RGBA, bottom row first
+         ci::ivec2 size;
+         std::string path;
+      };
+
+      using VReadback = std::vector<Readback>;
+      using VPbo = std::vector<ci::gl::PboRef>;
+      using DImage = std::deque<Image>;
+
+      void finishReadback(Readback* pReadback);
+      void dropReadback(const Readback& rReadback);
+      void work();
+
+      std::string mStem;
+      int mNextIndex{ -1 };
+      VReadback mReadbacks;
+      VPbo mFreePbos;
+      bool mStopFlag{ false };
+      DImage mImages;
+      std::mutex mMutex;
+      std::condition_variable mCondition;
+      std::thread mThread;
+};
@@ -0,0 +1,143 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "TypingTutorInterface.h"
+#include "AppState.h"
+#include "AssetCache.h"
+#include "KeyboardLayout.h"
+#include "LayerCache.h"
+
+#include "cinder/app/Window.h"
+#include "cinder/gl/Texture.h"
+#include "cinder/Signals.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class AssetLoader;
+class Game;
+class SessionLog;
+
+// One student at one window: the menus, the game being played, the skill and
+// duration chosen, and the session log of the student. The assets, the audio
+// mixer, the font and the profiler belong to the app and are shared by all
+// the seats; the sprite batch and the text renderer are per seat, as their
+// vertex arrays belong to the GL context of the window.
+//
+// The background and whatever the state draws as static, the keyboard of a
+// game, are kept in a LayerCache of the window, painted again only when the
+// state changes, the background arrives or the window is resized.
+//
+// A frame is update() on the main thread, advance() on any thread, alongside
+// the other seats, then endUpdate() on the main thread. A new game chosen
+// while assets are still loading stays pending, behind the menu, until
+// update() finds the loader done.
+class Seat : public TypingTutorInterface {
+   public:
+      struct Shared {
+         AssetCacheRef assets;
+         AssetLoader* pLoader{ nullptr };
+         FrameProfiler* pProfiler{ nullptr };
+         ScreenCapture* pScreenCapture{ nullptr };
+         const TextRenderer* pFont{ nullptr };
+         ci::gl::TextureRef background;
+         KeyboardLayout layout{ KeyboardLayout::qwerty() };
+         bool adaptiveFlag{ false };
+      };
+
+      Seat(const ci::app::WindowRef& window, const std::string& student, const Shared* pShared);
+      virtual ~Seat();
+
+      void update();
+      void advance();
+      void endUpdate();
+      void draw();
+      void keyDown(int code);
+      void releaseRenderers();
+      const ci::app::WindowRef& getWindow() const;
+      bool isQuitting() const;
+      bool isWindowClosed() const;
+
+      virtual void setState(State state) override final;
+      virtual void goBackToPreviousState() override final;
+      virtual void setSkill(Skill skill) override final;
+      virtual void setGameDuration(double seconds) override final;
+      virtual bool isGameRunning() override final;
+      virtual ci::ivec2 getWindowSize() const override final;
+      virtual TextRenderer& getTextRenderer() override final;
+      virtual SpriteBatch& getSpriteBatch() override final;
+      virtual FrameProfiler& getProfiler() override final;
+      virtual ScreenCapture& getScreenCapture() override final;
+
+   private:
+      using UniqueAppState = std::unique_ptr<AppState>;
+      using VUniqueAppState = std::vector<UniqueAppState>;
+
+      void openSessionLog(const std::string& student);
+      void positionWindow();
+      void drawBg();
+      void resetGame();
+      Game* getPlayedGame() const;
+
+      bool mPositionWindowOnceFlag{ true };
+      bool mNewGamePendingFlag{ false };
+      bool mQuitFlag{ false };
+      bool mWindowClosedFlag{ false };
+      const Shared* mSharedPtr{ nullptr };
+      ci::app::WindowRef mWindow;
+      ci::signals::ScopedConnection mCloseConnection;
+      std::unique_ptr<SessionLog> mSessionLog;
+      std::unique_ptr<SpriteBatch> mSpriteBatch;
+      std::unique_ptr<TextRenderer> mTextRenderer;
+      std::unique_ptr<LayerCache> mLayer;
+      const ci::gl::Texture* mLayerBgPtr{ nullptr }; // the background in the layer
+      AppState* mAppStatePtr{ nullptr };
+      State mCurrentState{ State::Last };
+      VUniqueAppState mAppStates;
+      double mGameDuration{ 180.0 };
+      Skill mSkill{ Skill::Positioning };
+      State mCurrentGame{ State::Last };
+};
+
+inline
+const ci::app::WindowRef& Seat::getWindow() const
+{
+   return mWindow;
+}
+
+inline
+bool Seat::isQuitting() const
+{
+   return mQuitFlag;
+}
+
+inline
+bool Seat::isWindowClosed() const
+{
+   return mWindowClosedFlag;
+}
@@ -0,0 +1,90 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "TextureAtlas.h"
+
+#include "cinder/gl/gl.h"
+
+#include <vector>
+
+// Collects the textured quads of a frame (toons, key caps) and draws them in
+// submission order, with one instanced call per run of quads sharing a texture.
+class SpriteBatch {
+   public:
+      SpriteBatch();
+
+      void addSprite(const ci::gl::TextureRef& texture, const ci::Rectf& rect,
+         const ci::ColorA& tint = ci::ColorA(1, 1, 1, 1));
+      void addSprite(const TextureAtlas::Region& region, const ci::Rectf& rect,
+         const ci::ColorA& tint = ci::ColorA(1, 1, 1, 1));
+      void addSprite(const ci::gl::TextureRef& texture, const ci::Rectf& uv, const ci::vec2& center,
+         const ci::vec2& size, float angle, const ci::ColorA& tint);
+      void draw();
+
+   private:
+      struct Instance {
+         ci::vec2 center;
+         ci::vec2 size;
+         float angle;
+         ci::vec4 uv;
+         ci::ColorA tint;
+      };
+
+      using VInstance = std::vector<Instance>;
+
+      // consecutive instances drawn with the same texture
+      struct Run {
+         ci::gl::TextureRef texture;
+         size_t nbInstances;
+      };
+
+      using VRun = std::vector<Run>;
+
+      void buildShader();
+      void setInstanceAttribs(size_t firstInstance);
+      void setAttrib(const std::string& name, int nbComponents, size_t offset, size_t stride);
+
+      VRun mRuns;
+      VInstance mInstances;
+      ci::gl::GlslProgRef mShader;
+      ci::gl::VboRef mQuadVbo;
+      ci::gl::VboRef mInstanceVbo;
+      ci::gl::VaoRef mVao;
+};
+
+inline
+void SpriteBatch::addSprite(const ci::gl::TextureRef& texture, const ci::Rectf& rect, const ci::ColorA& tint)
+{
+   const auto uv = texture->getAreaTexCoords(texture->getBounds());
+   addSprite(texture, uv, rect.getCenter(), rect.getSize(), 0.0f, tint);
+}
+
+inline
+void SpriteBatch::addSprite(const TextureAtlas::Region& region, const ci::Rectf& rect, const ci::ColorA& tint)
+{
+   addSprite(region.texture, region.uv, rect.getCenter(), rect.getSize(), 0.0f, tint);
+}
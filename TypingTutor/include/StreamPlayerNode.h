@@ -0,0 +1,100 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/audio/InputNode.h"
+#include "cinder/audio/Source.h"
+#include "cinder/audio/dsp/RingBuffer.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class StreamPlayerNode;
+using StreamPlayerNodeRef = std::shared_ptr<StreamPlayerNode>;
+
+// Plays a sound file in a loop without decoding it all in memory. A thread
+// decodes ahead into one bounded ring buffer per channel; on end of file it
+// seeks back to the start and keeps writing, so the loop has no gap.
+class StreamPlayerNode : public ci::audio::InputNode {
+   public:
+      StreamPlayerNode(const ci::audio::SourceFileRef& sourceFile, double ringSeconds = 2.0);
+      virtual ~StreamPlayerNode();
+
+      size_t getRingBytes() const;
+      size_t getFullDecodeBytes() const;
+      double getDecodeSeconds() const;
+      int getUnderruns() const;
+      std::string getReport() const;
+
+   protected:
+      virtual void initialize() override;
+      virtual void uninitialize() override;
+      virtual void process(ci::audio::Buffer* buffer) override;
+
+   private:
+      using VRingBuffer = std::vector<std::unique_ptr<ci::audio::dsp::RingBuffer>>;
+
+      static const size_t CHUNK_FRAMES;
+
+      void decode();
+      bool decodeChunk();
+
+      ci::audio::SourceFileRef mSourceFile;
+      ci::audio::Buffer mChunk;
+      VRingBuffer mRingBuffers;
+      size_t mRingFrames{ 0 };
+      std::thread mThread;
+      std::atomic<bool> mRunningFlag{ false };
+      std::atomic<long long> mDecodeMicroseconds{ 0 };
+      std::atomic<int> mUnderruns{ 0 };
+};
+
+inline
+size_t StreamPlayerNode::getRingBytes() const
+{
+   return mRingFrames * mSourceFile->getNumChannels() * sizeof(float);
+}
+
+inline
+size_t StreamPlayerNode::getFullDecodeBytes() const
+{
+   return mSourceFile->getNumFrames() * mSourceFile->getNumChannels() * sizeof(float);
+}
+
+inline
+double StreamPlayerNode::getDecodeSeconds() const
+{
+   return 1.0e-6 * mDecodeMicroseconds;
+}
+
+inline
+int StreamPlayerNode::getUnderruns() const
+{
+   return mUnderruns;
+}
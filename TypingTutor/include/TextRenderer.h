@@ -0,0 +1,119 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/gl/gl.h"
+
+#include <string>
+#include <vector>
+
+// Signed distance field text renderer. The glyph atlas is built once for a
+// given font; strings added during a frame are batched into a single vertex 
+// buffer and drawn, with their outline, in one shader pass.
+//
+// Vertex arrays are not shared between GL contexts, so each window needs a
+// renderer of its own; one made from another renderer shares its glyph atlas
+// and shader, and only has buffers of its own.
+class TextRenderer {
+   public:
+      TextRenderer(const std::string& fontName);
+      explicit TextRenderer(const TextRenderer* pFont);
+
+      void addString(const std::string& str, const ci::vec2& pos, float size,
+         const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth);
+      void addStringCentered(const std::string& str, const ci::vec2& pos, float size,
+         const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth);
+      void addStringRight(const std::string& str, const ci::vec2& pos, float size,
+         const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth);
+      float measureWidth(const std::string& str, float size) const;
+      void draw();
+
+   private:
+      enum class Align{ Left, Center, Right };
+
+      struct Glyph {
+         ci::Rectf uv;
+         ci::vec2 size;
+         float advance{ 0.0f };
+      };
+
+      struct Vertex {
+         ci::vec2 pos;
+         ci::vec2 uv;
+         ci::ColorA color;
+         ci::ColorA outlineColor;
+         float outlineEdge;
+      };
+
+      static const int FIRST_CHAR;
+      static const int LAST_CHAR;
+      static const int ATLAS_WIDTH;
+      static const float GLYPH_SIZE;
+      static const float SPREAD;
+
+      using VGlyph = std::vector<Glyph>;
+      using VVertex = std::vector<Vertex>;
+
+      void buildAtlas(const std::string& fontName);
+      void buildShader();
+      void buildBuffers();
+      const Glyph& getGlyph(char c) const;
+      float measureLine(const std::string& str, size_t begin, size_t end) const;
+      void addText(const std::string& str, const ci::vec2& pos, float size, Align align,
+         const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth);
+      void addGlyph(const Glyph& glyph, const ci::vec2& topLeft, float scale,
+         const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineEdge);
+      void setAttrib(const std::string& name, int nbComponents, size_t offset);
+
+      float mLineHeight{ 0.0f };
+      VGlyph mGlyphs;
+      VVertex mVertices;
+      ci::gl::Texture2dRef mAtlas;
+      ci::gl::GlslProgRef mShader;
+      ci::gl::VboRef mVbo;
+      ci::gl::VaoRef mVao;
+};
+
+inline
+void TextRenderer::addString(const std::string& str, const ci::vec2& pos, float size,
+   const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth)
+{
+   addText(str, pos, size, Align::Left, color, outlineColor, outlineWidth);
+}
+
+inline
+void TextRenderer::addStringCentered(const std::string& str, const ci::vec2& pos, float size,
+   const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth)
+{
+   addText(str, pos, size, Align::Center, color, outlineColor, outlineWidth);
+}
+
+inline
+void TextRenderer::addStringRight(const std::string& str, const ci::vec2& pos, float size,
+   const ci::ColorA& color, const ci::ColorA& outlineColor, float outlineWidth)
+{
+   addText(str, pos, size, Align::Right, color, outlineColor, outlineWidth);
+}
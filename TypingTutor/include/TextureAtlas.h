@@ -25,56 +25,51 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #pragma once
 
-#include "TypingTutorInterface.h"
 #include "cinder/gl/Texture.h"
+#include "cinder/Surface.h"
 
-class Toon {
+#include <memory>
+#include <vector>
+
+// Packs many small images into a few large texture pages. Images are added at
+// load time; each one gets a region that becomes valid once build() has
+// packed and uploaded the pages.
+class TextureAtlas {
    public:
-      Toon(const ci::fs::path& filename, double reducedTimeCoef);
+      struct Region {
+         ci::gl::TextureRef texture;
+         ci::Rectf uv;
+         ci::vec2 size;
+      };
+
+      using RegionRef = std::shared_ptr<Region>;
 
-      bool isAvailable() const;
-      bool isInGame() const;
-      bool isHurled() const;
-      void spawn();
-      bool draw(const TypingTutorInterface& rApp, const ci::Rectf& keyRect);
-      void update();
-      double hurl();
+      RegionRef add(const ci::Surface& surface);
+      void build();
+      int getNbPages() const;
 
    private:
-      void reset();
+      struct Entry {
+         ci::Surface surface;
+         RegionRef region;
+         ci::ivec2 pos;
+         int page{ 0 };
+      };
+
+      using VEntry = std::vector<Entry>;
+      using VTexture = std::vector<ci::gl::TextureRef>;
 
-      enum class State{ Available, Spawning, InGame, Hurled, Escaping };
+      static const int PAGE_SIZE;
+      static const int PADDING;
 
-      static const double SPAWNING_DURATION;
-      static const double ESCAPING_DURATION;
-      static const double INGAME_DURATION;
-      static const double SHAKING_DURATION;
-      static const double GRAVITY;
+      void packEntries(std::vector<ci::ivec2>* pPageSizes);
 
-      State mState{ State::Available };
-      ci::gl::TextureRef mTexture;
-      ci::Timer mTimer{ false };
-      double mScore{ 0.0 };
-      double mAngle{ 0.0 };
-      double mIngameDuration{ 0.0 };
-      double mShakingDuration{ 0.0 };
-      bool mCanEscapeFlag{ false };
+      VEntry mEntries;
+      VTexture mPages;
 };
 
 inline
-bool Toon::isAvailable() const
+int TextureAtlas::getNbPages() const
 {
-   return (mState == State::Available);
+   return static_cast<int>(mPages.size());
 }
-
-inline 
-bool Toon::isInGame() const
-{
-   return (mState == State::InGame);
-}
-
-inline
-bool Toon::isHurled() const
-{
-   return (mState == State::Hurled);
-}
\ No newline at end of file
@@ -26,6 +26,12 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "cinder/app/App.h"
+#include "Skill.h"
+
+class FrameProfiler;
+class ScreenCapture;
+class SpriteBatch;
+class TextRenderer;
 
 enum class State { 
    MenuApp,
@@ -42,15 +48,10 @@ enum class State {
    Last 
 };
 
-enum class Skill{ 
-   Positioning, 
-   HomeRow, 
-   Letters, 
-   Numbers, 
-   Last 
-};
-
-class TypingTutorInterface : public ci::app::App {
+// What a menu or a game sees of the seat it runs on: the state machine of
+// the seat, the size of its window and the renderers of that window. With a
+// single seat, it is the whole app.
+class TypingTutorInterface {
    public:
       virtual ~TypingTutorInterface() = 0 {}
       virtual void setState(State state) = 0;
@@ -58,4 +59,31 @@ class TypingTutorInterface : public ci::app::App {
       virtual void setSkill(Skill skill) = 0;
       virtual void setGameDuration(double seconds) = 0;
       virtual bool isGameRunning() = 0;
+      virtual ci::ivec2 getWindowSize() const = 0;
+      virtual TextRenderer& getTextRenderer() = 0;
+      virtual SpriteBatch& getSpriteBatch() = 0;
+      virtual FrameProfiler& getProfiler() = 0;
+      virtual ScreenCapture& getScreenCapture() = 0;
+
+      int getWindowWidth() const;
+      int getWindowHeight() const;
+      ci::Area getWindowBounds() const;
 };
+
+inline
+int TypingTutorInterface::getWindowWidth() const
+{
+   return getWindowSize().x;
+}
+
+inline
+int TypingTutorInterface::getWindowHeight() const
+{
+   return getWindowSize().y;
+}
+
+inline
+ci::Area TypingTutorInterface::getWindowBounds() const
+{
+   return ci::Area(ci::ivec2(0), getWindowSize());
+}
@@ -0,0 +1,86 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "cinder/audio/InputNode.h"
+#include "cinder/audio/Buffer.h"
+#include "cinder/audio/dsp/RingBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class VoiceMixerNode;
+using VoiceMixerNodeRef = std::shared_ptr<VoiceMixerNode>;
+
+// Plays the game sound effects from a fixed pool of voices summed into one
+// stereo output, so the same effect can overlap itself. When every voice is
+// busy, the one with the lowest priority, then the oldest, is stolen.
+class VoiceMixerNode : public ci::audio::InputNode {
+   public:
+      VoiceMixerNode(int nbVoices = 16, int maxNbSounds = 32);
+
+      int addSound(const ci::audio::BufferRef& buffer, float gain, int priority);
+      void setGain(int sound, float gain);
+      void play(int sound);
+      int getNbActiveVoices() const;
+
+   protected:
+      virtual void process(ci::audio::Buffer* buffer) override;
+
+   private:
+      struct Sound {
+         ci::audio::BufferRef buffer;
+         std::atomic<float> gain{ 1.0f };
+         int priority{ 0 };
+      };
+
+      struct Voice {
+         int sound{ -1 };
+         size_t pos{ 0 };
+         uint64_t startTick{ 0 };
+      };
+
+      using VSound = std::vector<std::unique_ptr<Sound>>;
+      using VVoice = std::vector<Voice>;
+
+      Voice* findVoice(int priority);
+      void mixVoice(Voice* pVoice, ci::audio::Buffer* buffer);
+
+      VSound mSounds;
+      std::atomic<int> mNbSounds{ 0 };
+      VVoice mVoices;
+      ci::audio::dsp::RingBufferT<int> mCommands;
+      uint64_t mTick{ 0 };
+      std::atomic<int> mNbActiveVoices{ 0 };
+};
+
+inline
+int VoiceMixerNode::getNbActiveVoices() const
+{
+   return mNbActiveVoices;
+}
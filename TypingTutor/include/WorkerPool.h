@@ -0,0 +1,71 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that run the same task for a range of indices, as a
+// parallel for. run() hands the indices out one at a time, works on them too,
+// and returns once they are all done. With no thread, run() is a plain loop.
+class WorkerPool {
+   public:
+      using Task = std::function<void(int)>;
+
+      explicit WorkerPool(int nbThreads);
+      ~WorkerPool();
+
+      void run(int nbTasks, const Task& task);
+      int getNbThreads() const;
+
+   private:
+      using VThread = std::vector<std::thread>;
+
+      void work();
+      void runTasks();
+
+      bool mStopFlag{ false };
+      uint64_t mGeneration{ 0 };
+      int mNbTasks{ 0 };
+      int mNbBusy{ 0 };
+      const Task* mTaskPtr{ nullptr };
+      std::atomic<int> mNextTask{ 0 };
+      VThread mThreads;
+      std::mutex mMutex;
+      std::condition_variable mWorkCondition;
+      std::condition_variable mDoneCondition;
+};
+
+inline
+int WorkerPool::getNbThreads() const
+{
+   return static_cast<int>(mThreads.size());
+}
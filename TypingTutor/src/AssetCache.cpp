@@ -0,0 +1,190 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "AssetCache.h"
+#include "KeyboardLayout.h"
+
+#include "cinder/app/App.h"
+#include "cinder/Text.h"
+
+#include <set>
+#include <sstream>
+
+using namespace ci;
+using namespace ci::app;
+
+gl::TextureRef AssetCache::getTexture(const fs::path& path)
+{
+   auto& rTexture = mTextures[path];
+   if (!rTexture) {
+      rTexture = gl::Texture::create(loadImage(path));
+   }
+   return rTexture;
+}
+
+AssetCache::VSurface AssetCache::loadToonSurfaces()
+{
+   VSurface surfaces;
+
+   try {
+      auto n = 0;
+      while (true) {
+         std::ostringstream filename;
+         filename << "images/toon" << n++ << ".png";
+         surfaces.emplace_back(loadImage(filename.str()));
+      }
+   }
+   catch (Exception) {
+      ; // it's expected; nothing to do
+   }
+
+   return surfaces;
+}
+
+void AssetCache::addToonSurfaces(const VSurface& surfaces)
+{
+   if (mToonsLoadedFlag) {
+      return; // a Game already loaded them on the spot
+   }
+   mToonsLoadedFlag = true;
+
+   for (const auto& rSurface : surfaces) {
+      mToonRegions.push_back(mAtlas.add(rSurface));
+      mAtlasDirtyFlag = true;
+   }
+}
+
+const AssetCache::VRegion& AssetCache::getToonRegions()
+{
+   if (!mToonsLoadedFlag) {
+      addToonSurfaces(loadToonSurfaces());
+   }
+   return mToonRegions;
+}
+
+TextureAtlas::RegionRef AssetCache::getKeyGlyph(const std::string& c, const Color& color)
+{
+   auto& rRegion = mKeyGlyphs[std::make_tuple(c, color.r, color.g, color.b)];
+   if (!rRegion) {
+      TextLayout layout;
+      layout.clear(Color(0, 0, 0));
+      layout.setColor(color);
+      layout.setFont(Font("Consolas", 72));
+      layout.addLine(c);
+      rRegion = mAtlas.add(layout.render(true, false));
+      mAtlasDirtyFlag = true;
+   }
+   return rRegion;
+}
+
+const VoiceMixerNodeRef& AssetCache::getMixer()
+{
+   if (!mMixer) {
+      auto ctx = audio::Context::master();
+
+      // a single node for every effect, connected once for the whole run
+      mMixer = ctx->makeNode(new VoiceMixerNode);
+      mMixer >> ctx->getOutput();
+      mMixer->enable();
+   }
+   return mMixer;
+}
+
+int AssetCache::getSound(const fs::path& path, float gain, int priority)
+{
+   auto it = mSounds.find(path);
+   if (it == mSounds.end()) {
+      const auto sound = getMixer()->addSound(getBuffer(path), gain, priority);
+      it = mSounds.emplace(path, sound).first;
+   }
+   else {
+      getMixer()->setGain(it->second, gain);
+   }
+   return it->second;
+}
+
+void AssetCache::buildAtlas()
+{
+   if (mAtlasDirtyFlag) {
+      mAtlasDirtyFlag = false;
+      mAtlas.build();
+   }
+}
+
+audio::BufferRef AssetCache::getBuffer(const fs::path& path)
+{
+   auto& rBuffer = mBuffers[path];
+   if (!rBuffer) {
+      // create a SourceFile and set its output samplerate to match the Context.
+      const auto sampleRate = audio::Context::master()->getSampleRate();
+      audio::SourceFileRef audioFile = audio::load(loadFile(path), sampleRate);
+
+      // load the entire sound file into a BufferRef
+      rBuffer = audioFile->loadBuffer();
+   }
+   return rBuffer;
+}
+
+void AssetCache::preload(const KeyboardLayout& layout, AssetLoader* pLoader)
+{
+   assert(pLoader != nullptr);
+
+   // the jobs only decode; the finalizers touch the cache on the GL thread
+   const std::set<std::string> images(layout.images.cbegin(), layout.images.cend()); // a skill may share its image
+   for (const auto& path : images) {
+      pLoader->enqueue([this, path]() -> AssetLoader::Finalizer {
+         const auto surface = Surface(loadImage(path));
+         return [this, path, surface]() {
+            auto& rTexture = mTextures[path];
+            if (!rTexture) { rTexture = gl::Texture::create(surface); }
+         };
+      });
+   }
+
+   pLoader->enqueue([this]() -> AssetLoader::Finalizer {
+      const auto surfaces = loadToonSurfaces();
+      return [this, surfaces]() { addToonSurfaces(surfaces); };
+   });
+
+   const char* sounds[] = {
+      "sounds/grow.mp3",
+      "sounds/shrink.mp3",
+      "sounds/boing1.mp3",
+      "sounds/boing2.mp3",
+      "sounds/boing3.mp3",
+      "sounds/buzz.mp3",
+      "sounds/streak.mp3"
+   };
+   const auto sampleRate = audio::Context::master()->getSampleRate();
+   for (const auto path : sounds) {
+      pLoader->enqueue([this, path, sampleRate]() -> AssetLoader::Finalizer {
+         const auto buffer = audio::load(loadFile(path), sampleRate)->loadBuffer();
+         return [this, path, buffer]() {
+            auto& rBuffer = mBuffers[path];
+            if (!rBuffer) { rBuffer = buffer; }
+         };
+      });
+   }
+}
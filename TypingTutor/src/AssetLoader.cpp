@@ -0,0 +1,145 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "AssetLoader.h"
+
+#include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+#include <algorithm>
+#include <exception>
+
+using namespace ci;
+
+AssetLoader::AssetLoader()
+{
+   // leave a core to the GL thread
+   const auto nbThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+   for (auto i = 0; i < nbThreads; ++i) {
+      mThreads.emplace_back(&AssetLoader::work, this);
+   }
+}
+
+AssetLoader::~AssetLoader()
+{
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStopFlag = true;
+      mJobs.clear();
+   }
+   mJobCondition.notify_all();
+
+   for (auto& rThread : mThreads) {
+      rThread.join();
+   }
+}
+
+void AssetLoader::enqueue(const Job& job)
+{
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mJobs.push_back(job);
+   }
+   ++mNbJobs;
+   mJobCondition.notify_one();
+}
+
+void AssetLoader::work()
+{
+   while (true) {
+      Job job;
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+         mJobCondition.wait(lock, [this]{ return mStopFlag || !mJobs.empty(); });
+         if (mStopFlag) {
+            return;
+         }
+         job = mJobs.front();
+         mJobs.pop_front();
+         ++mNbRunning;
+      }
+
+      Finalizer finalizer;
+      try {
+         finalizer = job();
+      }
+      catch (std::exception& exc) {
+         CI_LOG_EXCEPTION("failed to load an asset.", exc);
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(mMutex);
+         // an empty finalizer is still queued so the job is counted as done
+         mFinalizers.push_back(finalizer);
+         --mNbRunning;
+      }
+      mDoneCondition.notify_all();
+   }
+}
+
+bool AssetLoader::finalizeOne()
+{
+   Finalizer finalizer;
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (mFinalizers.empty()) {
+         return false;
+      }
+      finalizer = mFinalizers.front();
+      mFinalizers.pop_front();
+   }
+
+   try {
+      if (finalizer) { finalizer(); }
+   }
+   catch (std::exception& exc) {
+      CI_LOG_EXCEPTION("failed to finalize an asset.", exc);
+   }
+
+   ++mNbFinalized;
+   return true;
+}
+
+void AssetLoader::update(double timeBudget)
+{
+   // at least one finalizer per frame, then as many as the budget allows
+   Timer timer(true);
+   while (finalizeOne() && timer.getSeconds() < timeBudget) {
+      ;
+   }
+}
+
+void AssetLoader::flush()
+{
+   while (!isDone()) {
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+         mDoneCondition.wait(lock, [this]{ return !mFinalizers.empty() || (mJobs.empty() && mNbRunning == 0); });
+      }
+      while (finalizeOne()) {
+         ;
+      }
+   }
+}
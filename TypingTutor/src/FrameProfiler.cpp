@@ -0,0 +1,152 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "FrameProfiler.h"
+#include "TextRenderer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace ci;
+
+const int FrameProfiler::NB_FRAMES = 600;
+const double FrameProfiler::HUD_REFRESH_PERIOD = 0.5;
+const char* const FrameProfiler::PHASE_NAMES[] = {
+   "frame",
+   "update",
+   "loader",
+   "state update",
+   "draw",
+   "background",
+   "keyboard",
+   "toons",
+   "hud",
+};
+
+FrameProfiler::FrameProfiler() :
+mFrames(NB_FRAMES)
+{
+   mCurrentFrame.fill(0.0f);
+}
+
+void FrameProfiler::beginFrame()
+{
+   // the frame time runs from one call to the next
+   if (!mFrameTimer.isStopped()) {
+      add(Phase::Frame, mFrameTimer.getSeconds());
+
+      mFrames[mNbFramesDone % NB_FRAMES] = mCurrentFrame;
+      ++mNbFramesDone;
+   }
+
+   mCurrentFrame.fill(0.0f);
+   mFrameTimer.start();
+}
+
+int FrameProfiler::copyFrames(VFrame* pFrames) const
+{
+   const auto nbFrames = std::min<uint32_t>(mNbFramesDone, NB_FRAMES);
+
+   pFrames->clear();
+   for (auto i = mNbFramesDone - nbFrames; i < mNbFramesDone; ++i) {
+      pFrames->push_back(mFrames[i % NB_FRAMES]);
+   }
+   return static_cast<int>(nbFrames);
+}
+
+FrameProfiler::Stats FrameProfiler::computeStats(Phase phase) const
+{
+   VFrame frames;
+   copyFrames(&frames);
+
+   Stats stats;
+   if (frames.empty()) {
+      return stats;
+   }
+
+   std::vector<float> times;
+   for (const auto& rFrame : frames) {
+      times.push_back(rFrame[static_cast<int>(phase)]);
+   }
+   std::sort(times.begin(), times.end());
+
+   double sum = 0.0;
+   for (const auto t : times) { sum += t; }
+
+   stats.min = times.front();
+   stats.avg = sum / times.size();
+   stats.p99 = times[(times.size() - 1) * 99 / 100];
+   return stats;
+}
+
+void FrameProfiler::drawHud(TextRenderer& rText, const vec2& pos)
+{
+   // the statistics are recomputed a few times a second so they can be read
+   if (mHudLines.empty() || mHudTimer.getSeconds() > HUD_REFRESH_PERIOD) {
+      mHudTimer.start();
+      mHudLines.clear();
+      mHudLines.push_back("ms             min    avg    p99");
+      for (auto i = 0; i < NB_PHASES; ++i) {
+         const auto stats = computeStats(static_cast<Phase>(i));
+         std::ostringstream ss;
+         ss << std::left << std::setw(13) << PHASE_NAMES[i] << std::right << std::fixed << std::setprecision(2)
+            << std::setw(7) << stats.min << std::setw(7) << stats.avg << std::setw(7) << stats.p99;
+         mHudLines.push_back(ss.str());
+      }
+   }
+
+   const auto lineHeight = 22.0f;
+   auto linePos = pos;
+   for (const auto& rLine : mHudLines) {
+      rText.addString(rLine, linePos, 20.0f, ColorA(1, 1, 1, 1), ColorA(0, 0, 0, 0.7f), 0.5f);
+      linePos.y += lineHeight;
+   }
+}
+
+void FrameProfiler::dump(const std::string& path) const
+{
+   VFrame frames;
+   copyFrames(&frames);
+
+   std::ofstream ofs(path);
+   if (!ofs) {
+      throw std::runtime_error("cannot write " + path);
+   }
+
+   for (auto i = 0; i < NB_PHASES; ++i) {
+      ofs << (i > 0 ? "," : "") << PHASE_NAMES[i];
+   }
+   ofs << "\n";
+
+   for (const auto& rFrame : frames) {
+      for (auto i = 0; i < NB_PHASES; ++i) {
+         ofs << (i > 0 ? "," : "") << rFrame[i];
+      }
+      ofs << "\n";
+   }
+}
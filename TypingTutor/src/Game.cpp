@@ -24,9 +24,14 @@ TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "Game.h"
+#include "TextRenderer.h"
+#include "SpriteBatch.h"
+#include "FileUtils.h"
+#include "FrameProfiler.h"
+#include "ScreenCapture.h"
 
-#include "cinder/Rand.h"
 #include "cinder/gl/gl.h"
+#include "cinder/Log.h"
 
 #include <algorithm>
 #include <sstream>
@@ -37,70 +42,74 @@ using namespace ci::app;
 const ColorA Game::TRANSPARENT_BLACK = ColorA(0, 0, 0, 0.7f);
 const Colorf Game::GREEN = Colorf(75.0f / 255.0f, 170.0f / 255.0f, 66.0f / 255.0f);
 const Colorf Game::WHITE = Colorf(1.0f, 1.0f, 1.0f);
-const double Game::STREAK_BONUS_EXPIRATION = 1.0;
+const double Game::MAX_FRAME_TIME = 0.25;
 
-Game::Game(double duration, double gameSpeedCoef) :
-mDuration(duration),
-mGameSpeedCoef(gameSpeedCoef)
+Game::Game(const GameRules& rules, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog) :
+mAssets(assets),
+mCore(rules, layout, seed),
+mRecorder(&mCore),
+mKb(&mCore.getKeyboard())
 {
+   assert(mAssets);
+
    loadToons();
+   mKb.setTexture(mAssets->getTexture(layout.getImage(rules.skill)));
+   mKb.generateTextures(mAssets.get());
+   mAssets->buildAtlas();
    loadSounds();
+
+   mCore.addObserver(this);
+
+   if (pSessionLog != nullptr) {
+      mSessionRecorder.reset(new SessionRecorder(&mCore, pSessionLog));
+   }
 }
 
 void Game::loadToons()
 {
-   try {
-      auto n = 0;
-      while (true) {
-         std::ostringstream filename;
-         filename << "images/toon" << n++ << ".png";
-         Toon toon(filename.str(), mGameSpeedCoef);
-         mToons.push_back(toon);
-      }
-   }
-   catch (Exception) {
-      ; // it's expected; nothing to do
+   mToonRegions = mAssets->getToonRegions();
+   for (const auto& rRegion : mToonRegions) {
+      mCore.addToon(rRegion->size);
    }
-
-   const auto NbToonsLoaded = static_cast<int>(mToons.size());
-   mMaxNbToons = std::min<int>(NbToonsLoaded, mMaxNbToons);
 }
 
 void Game::loadSounds()
 {
    auto ctx = audio::Context::master();
 
-   loadSound("sounds/grow.mp3"  , 0.3f, ctx, &mToonGrowPlayerNode   , &mToonGrowGain   );
-   loadSound("sounds/shrink.mp3", 0.3f, ctx, &mToonShrinkPlayerNode , &mToonShrinkGain );
-   loadSound("sounds/boing1.mp3", 1.0f, ctx, &mToonBoing1PlayerNode , &mToonBoing1Gain );
-   loadSound("sounds/boing2.mp3", 1.0f, ctx, &mToonBoing2PlayerNode , &mToonBoing2Gain );
-   loadSound("sounds/boing3.mp3", 1.0f, ctx, &mToonBoing3PlayerNode , &mToonBoing3Gain );
-   loadSound("sounds/buzz.mp3"  , 0.3f, ctx, &mToonBuzzPlayerNode   , &mToonBuzzGain   );
-   loadSound("sounds/streak.mp3", 1.0f, ctx, &mStreakBonusPlayerNode, &mStreakBonusGain);
+   // the priority decides which voice is stolen when they are all busy
+   loadSound("sounds/grow.mp3"  , 0.3f, 0, &mToonGrowSound   );
+   loadSound("sounds/shrink.mp3", 0.3f, 1, &mToonShrinkSound );
+   loadSound("sounds/boing1.mp3", 1.0f, 1, &mToonBoing1Sound );
+   loadSound("sounds/boing2.mp3", 1.0f, 1, &mToonBoing2Sound );
+   loadSound("sounds/boing3.mp3", 1.0f, 1, &mToonBoing3Sound );
+   loadSound("sounds/buzz.mp3"  , 0.3f, 2, &mToonBuzzSound   );
+   loadSound("sounds/streak.mp3", 1.0f, 3, &mStreakBonusSound);
 
    ctx->enable();
 }
 
-void Game::loadSound(
-   const fs::path& path,
-   float gain,
-   audio::Context* ctx, 
-   ci::audio::BufferPlayerNodeRef* pPlayerNodeRef, 
-   ci::audio::GainNodeRef* pGainNodeRef)
+void Game::loadSound(const fs::path& path, float gain, int priority, int* pSound)
 {
-   // create a SourceFile and set its output samplerate to match the Context.
-   audio::SourceFileRef audioFile = audio::load(loadFile(path));
-
-   // load the entire sound file into a BufferRef, and construct a BufferPlayerNode with this.
-   audio::BufferRef audioBuffer = audioFile->loadBuffer();
+   assert(pSound != nullptr);
 
-   *pPlayerNodeRef = ctx->makeNode(new audio::BufferPlayerNode(audioBuffer));
+   // decoded once by the cache and shared by every round
+   *pSound = mAssets->getSound(path, gain, priority);
+}
 
-   // add a Gain to adjust the volume
-   *pGainNodeRef = ctx->makeNode(new audio::GainNode(gain));
+void Game::playSound(int sound)
+{
+   // the mixer takes its commands from one thread
+   mPendingSounds.push_back(sound);
+}
 
-   // connect and enable the Context
-   *pPlayerNodeRef >> *pGainNodeRef >> ctx->getOutput();
+void Game::playPendingSounds()
+{
+   const auto& rMixer = mAssets->getMixer();
+   for (const auto sound : mPendingSounds) {
+      rMixer->play(sound);
+   }
+   mPendingSounds.clear();
 }
 
 void Game::update(TypingTutorInterface* pApp)
@@ -111,267 +120,189 @@ void Game::update(TypingTutorInterface* pApp)
       return; // changing state; make a quick return
    }
 
-   if (mTimer.isStopped()) {
-      mTimer.resume();
+   if (mClock.isStopped()) {
+      mClock.resume();
    }
 
-   if (mTimer.getSeconds() + mTimePenalty > mDuration) {
-      mState = GameState::GameOver;
-   }
-   else {
-      if (mTimer.getSeconds() > mSpawningTime) {
+   mKb.updateLayout(*pApp);
+   mCore.setBounds(Rectf(pApp->getWindowBounds()));
 
-         if (mState == GameState::Preset) {
-            mState = GameState::Playing;
-            mTimer.stop();
-            mTimer.start();
-         }
-
-         const auto pToon = randSelectToon();
-         const auto key = mKb.randSelectKey();
-         if (pToon != nullptr && key != KeyEvent::KEY_UNKNOWN) {
-            mKeyToonPairs.emplace_back(key, pToon);
-            mKb.selectKey(key);
-            pToon->spawn();
-            mToonGrowPlayerNode->start();
-         }
-         updateNextSpawingTime();
-      }
-
-      for (auto& i : mKeyToonPairs) {
-         const auto keyCode = i.first;
-         const auto pToon = i.second;
-         pToon->update();
-      }
+   // the simulation advances in fixed steps, whatever the frame rate; a long
+   // stall is clamped so it does not turn into a burst of steps
+   const auto clockTime = mClock.getSeconds();
+   mAccumulator += std::min(clockTime - mLastClockTime, MAX_FRAME_TIME);
+   mLastClockTime = clockTime;
+}
 
-      mKeyToonPairs.erase(
-         std::remove_if(
-            mKeyToonPairs.begin(),
-            mKeyToonPairs.end(),
-            [](const KeyToonPair& r){ return r.second->isAvailable(); }),
-         mKeyToonPairs.end());
+void Game::advance()
+{
+   while (mAccumulator >= GameCore::TIME_STEP) {
+      mAccumulator -= GameCore::TIME_STEP;
+      mCore.step();
    }
-
-   const auto time = mTimer.getSeconds();
-   mStreakBonuses.erase(
-      std::remove_if(
-         mStreakBonuses.begin(),
-         mStreakBonuses.end(),
-         [time](const StreakBonus& r){ return time > r.expiration; }),
-      mStreakBonuses.end());
 }
 
-int Game::countInGameToons() const
+void Game::endUpdate()
 {
-   const auto n = std::count_if(mToons.cbegin(), mToons.cend(),
-      [](const Toon& r){ return r.isInGame(); });
+   playPendingSounds();
 
-   return static_cast<int>(n);
+   if (mCore.getState() == GameCore::State::GameOver && !mReplaySavedFlag) {
+      mReplaySavedFlag = true;
+      saveReplay();
+      if (mSessionRecorder) { mSessionRecorder->finish(); }
+   }
 }
 
-int Game::countAvailableToons() const
+void Game::saveReplay()
 {
-   const auto n = std::count_if(mToons.cbegin(), mToons.cend(),
-      [](const Toon& r){ return r.isAvailable(); });
-
-   return static_cast<int>(n);
+   try {
+      fs::create_directories("replays");
+      mRecorder.getLog().save(findFreePath("replays/tt", ".ttr"));
+   }
+   catch (std::exception& exc) {
+      CI_LOG_EXCEPTION("failed to save the replay.", exc);
+   }
 }
 
-Toon* Game::randSelectToon()
+double Game::getRenderTime() const
 {
-   const auto nbToonsInGame = countInGameToons();
-
-   if (nbToonsInGame < mMaxNbToons) {
-      const auto nbToons = static_cast<int>(mToons.size());
-      const auto nbAvailableToons = countAvailableToons();
-      if (nbAvailableToons > 0) {
-         auto randToonNumber = Rand::randInt(nbAvailableToons);
-         for (auto& rToon : mToons) {
-            if (rToon.isAvailable()) {
-               if (--randToonNumber < 0) {
-                  return &rToon;
-               }
-            }
-         }
-      }
-   }
-   return nullptr;
+   return mCore.getTime() + mAccumulator;
 }
 
-void Game::updateNextSpawingTime()
+void Game::drawStatic(TypingTutorInterface& rApp)
 {
-   const auto randNumber = Rand::randFloat(0.3f, 1.0f);
-   const auto timeCoef = (mGameSpeedCoef > 0.0) ? mGameSpeedCoef : 1.0;
-   mSpawningTime = mTimer.getSeconds() + timeCoef * randNumber;
+   // the keyboard only moves with the window, which may have just been resized
+   FrameProfiler::Scope scope(rApp.getProfiler(), FrameProfiler::Phase::Keyboard);
+   mKb.updateLayout(rApp);
+   mKb.draw(rApp);
 }
 
-void Game::draw(const TypingTutorInterface& rApp)
+void Game::draw(TypingTutorInterface& rApp)
 {
-   gl::drawStringCentered("Esc: main menu, F1: screenshot (saved in screens folder)", vec2(0.5*rApp.getWindowWidth(), 5), TRANSPARENT_BLACK, Font("Comic Sans MS", 20));
-   gl::drawStringCentered("Esc: main menu, F1: screenshot (saved in screens folder)", vec2(0.5*rApp.getWindowWidth(), 5), WHITE            , Font("Comic Sans MS", 20));
+   auto& rProfiler = rApp.getProfiler();
+   auto& rText = rApp.getTextRenderer();
+
+   {
+      FrameProfiler::Scope scope(rProfiler, FrameProfiler::Phase::Hud);
+      rText.addStringCentered("Esc: main menu, F1: screenshot (saved in screens folder)", vec2(0.5*rApp.getWindowWidth(), 5), 20.0f, WHITE, TRANSPARENT_BLACK, 0.0f);
+      mTimeBar.draw(rApp, mCore.computeFillRatio(getRenderTime()), mCore.getDuration());
+      drawScore(rApp);
+      drawStreak(rApp);
+
+      if (mCore.getState() == GameCore::State::GameOver) {
+         drawGameOver(rApp);
+      }
 
-   mKb.draw(rApp);
-   mTimeBar.draw(rApp, computeFillRatio(), mDuration);
-   drawScore(rApp);
-   drawStreak(rApp);
-
-   for (auto it = mKeyToonPairs.crbegin(); it != mKeyToonPairs.crend(); ++it) {
-      const auto keyCode = it->first;
-      const auto pToon = it->second;
-      const auto escapedFlag = pToon->draw(rApp, mKb.getKeyRectf(it->first));
-      if (escapedFlag) {
-         resetStreakCount();
-         mToonShrinkPlayerNode->start();
-         mKb.deselectKey(keyCode);
+      for (const auto& i : mCore.getStreakBonuses()) {
+         const auto offset = GameCore::STREAK_BONUS_EXPIRATION - std::max(i.expiration - getRenderTime(), 0.0);
+         const auto pos = i.pos - vec2(0, 10.0 * offset);
+         rText.addStringCentered(i.bonus, pos, 72.0f, WHITE, TRANSPARENT_BLACK, 1.5f);
       }
    }
 
-   for (auto it = mKeyToonPairs.crbegin(); it != mKeyToonPairs.crend(); ++it) {
-      const auto pToon = it->second;
-      if (pToon->isInGame()) {
-         mKb.drawKey(it->first);
+   {
+      FrameProfiler::Scope scope(rProfiler, FrameProfiler::Phase::Toons);
+
+      // draw only reads the simulation; alpha is how far we are into the next step
+      const auto alpha = mAccumulator / GameCore::TIME_STEP;
+      const auto& rToons = mCore.getToons();
+      const auto& rPairs = mCore.getKeyToonPairs();
+      for (auto it = rPairs.crbegin(); it != rPairs.crend(); ++it) {
+         const auto toon = it->second;
+         if (!rToons.isAvailable(toon)) {
+            rApp.getSpriteBatch().addSprite(*mToonRegions[toon], rToons.getRect(toon, alpha));
+         }
       }
-   }
 
-   if (mState == GameState::GameOver) {
-      drawGameOver(rApp);
-      if (mPerfectGameBonusOnceFlag && mPerfectGameFlag) {
-         mPerfectGameBonusOnceFlag = false;
-         newStreakBonus(mScore, rApp.getWindowCenter());
+      for (auto it = rPairs.crbegin(); it != rPairs.crend(); ++it) {
+         if (rToons.isInGame(it->second)) {
+            mKb.drawKey(rApp, it->first);
+         }
       }
+
+      // the toons and key caps go out in one instanced call per texture
+      rApp.getSpriteBatch().draw();
+   }
+
+   {
+      // then all the HUD strings of the frame in a single draw call
+      FrameProfiler::Scope scope(rProfiler, FrameProfiler::Phase::Hud);
+      rText.draw();
    }
 
-   for (const auto& i : mStreakBonuses) {
-      const auto offset = STREAK_BONUS_EXPIRATION - std::max(i.expiration - mTimer.getSeconds(), 0.0);
-      const auto pos = i.pos - vec2(0, 10.0 * offset);
-      gl::drawStringCentered(i.bonus, pos, TRANSPARENT_BLACK, Font("Comic Sans MS", 75));
-      gl::drawStringCentered(i.bonus, pos, WHITE            , Font("Comic Sans MS", 72));
+   if (mScreenshotFlag) {
+      mScreenshotFlag = false;
+      rApp.getScreenCapture().capture(rApp.getWindowBounds());
    }
 }
 
-void Game::drawStreak(const TypingTutorInterface& rApp) const
+void Game::drawStreak(TypingTutorInterface& rApp) const
 {
    std::ostringstream ss;
-   ss << mStreakCnt << "/" << mStreakThreshold;
+   ss << mCore.getStreakCnt() << "/" << mCore.getStreakThreshold();
    const auto pos = vec2(rApp.getWindowWidth(), rApp.getWindowHeight() - 45);
-   gl::drawStringRight(ss.str(), pos, TRANSPARENT_BLACK, Font("Comic Sans MS", 38.5));
-   gl::drawStringRight(ss.str(), pos, WHITE            , Font("Comic Sans MS", 38));
+   rApp.getTextRenderer().addStringRight(ss.str(), pos, 38.0f, WHITE, TRANSPARENT_BLACK, 0.5f);
 }
 
 
-void Game::drawScore(const TypingTutorInterface& rApp) const
+void Game::drawScore(TypingTutorInterface& rApp) const
 {
    std::ostringstream scoreStringStream;
-   scoreStringStream << static_cast<int>(mScore);
-   gl::drawStringCentered(scoreStringStream.str(), vec2(0.5*rApp.getWindowWidth(), 8), TRANSPARENT_BLACK, Font("Comic Sans MS", 75));
-   gl::drawStringCentered(scoreStringStream.str(), vec2(0.5*rApp.getWindowWidth(), 8), WHITE            , Font("Comic Sans MS", 72));
+   scoreStringStream << static_cast<int>(mCore.getScore());
+   rApp.getTextRenderer().addStringCentered(scoreStringStream.str(), vec2(0.5*rApp.getWindowWidth(), 8), 72.0f, WHITE, TRANSPARENT_BLACK, 1.5f);
 }
 
-void Game::drawGameOver(const TypingTutorInterface& rApp) const
+void Game::drawGameOver(TypingTutorInterface& rApp) const
 {
-   std::string text = mPerfectGameFlag ? "PERFECT\nGAME !!!" : "GAME OVER";
-   const auto pos = vec2((float)getWindowWidth() * 0.5f, (float)getWindowHeight() * 0.3f);
-   gl::drawStringCentered(text, pos, TRANSPARENT_BLACK, Font("Comic Sans MS", 185));
-   gl::drawStringCentered(text, pos, WHITE            , Font("Comic Sans MS", 180));
-}
-
-double Game::computeFillRatio() const
-{
-   if (mState == GameState::Preset) {
-      const auto ratio = 1.0 - std::min(mTimer.getSeconds() / mSpawningTime, 1.0);
-      return ratio; 
-   }
-
-   const auto ratio = std::min((mTimer.getSeconds() + mTimePenalty) / mDuration, 1.0);
-   return ratio;
+   std::string text = mCore.isPerfectGame() ? "PERFECT\nGAME !!!" : "GAME OVER";
+   const auto pos = vec2(rApp.getWindowWidth() * 0.5f, rApp.getWindowHeight() * 0.3f);
+   rApp.getTextRenderer().addStringCentered(text, pos, 180.0f, WHITE, TRANSPARENT_BLACK, 2.5f);
 }
 
 void Game::keyDown(int code)
 {
    if (code == KeyEvent::KEY_ESCAPE) {
       mKeyEscapeFlag = true;
-      mTimer.stop();
+      mClock.stop();
    }
    else if (code == KeyEvent::KEY_F1) {
-      std::ifstream ifs;
-      std::ostringstream ss;
-      auto fileNum = -1;
-      do {
-         ifs.close();
-         ss.str(std::string());
-         ss << "screens/tt" << ++fileNum << ".png";
-         ifs.open(ss.str());
-      } while (ifs.is_open());
-      ifs.close();
-      writeImage(ss.str(), copyWindowSurface());
+      mScreenshotFlag = true; // taken at the end of the next draw
    }
-   else if (mState == GameState::Playing) {
-      auto WrongKeyPressed = true;
-
-      for (auto& i : mKeyToonPairs) {
-         const auto keyCode = i.first;
-         auto pToon = i.second;
-         if (keyCode == code && pToon->isInGame()) {
-            WrongKeyPressed = false;
-            mKb.deselectKey(keyCode);
-            const auto score = pToon->hurl();
-            playBoing(score);
-            mScore += score;
-            incStreakCount(keyCode);
-            break;
-         }
-      }
-
-      if (WrongKeyPressed) {
-         mTimePenalty += 1.0;
-         mToonBuzzPlayerNode->start();
-         resetStreakCount();
-      }
+   else {
+      mCore.keyDown(code);
+      playPendingSounds(); // a hit is heard right away, not a frame later
    }
 }
 
-void Game::incStreakCount(int keyCode)
+void Game::onToonSpawned(int /*keyCode*/)
+{
+   playSound(mToonGrowSound);
+}
+
+void Game::onToonHurled(int /*keyCode*/, double score)
 {
-   if (++mStreakCnt == mStreakThreshold) {
-      mStreakCntFloor = mStreakCnt;
-      const auto pos = mKb.getKeyRectf(keyCode).getCenter();
-      const auto bonus = 10 * mStreakThreshold;
-      newStreakBonus(bonus, pos);
-      const auto streakAdd = std::min(mStreakThreshold, mStreakMaxInc);
-      mStreakThreshold += streakAdd;
+   if (score > 6.0) {
+      playSound(mToonBoing1Sound);
+   }
+   else if (score > 3.0) {
+      playSound(mToonBoing2Sound);
+   }
+   else {
+      playSound(mToonBoing3Sound);
    }
 }
 
-void Game::newStreakBonus(double bonus, vec2 pos)
+void Game::onToonEscaped(int /*keyCode*/)
 {
-   std::ostringstream bonusStringStream;
-   bonusStringStream << "+" << bonus;
-
-   StreakBonus streakBonus;
-   streakBonus.pos = pos;
-   streakBonus.bonus = bonusStringStream.str();
-   streakBonus.expiration = mTimer.getSeconds() + STREAK_BONUS_EXPIRATION;
-   mStreakBonuses.emplace_back(streakBonus);
-   
-   mScore += bonus;
-   mStreakBonusPlayerNode->start();
+   playSound(mToonShrinkSound);
 }
 
-void Game::resetStreakCount()
+void Game::onWrongKey(int /*keyCode*/)
 {
-   mStreakCnt = mStreakCntFloor;
-   mPerfectGameFlag = false;
+   playSound(mToonBuzzSound);
 }
 
-void Game::playBoing(double score)
+void Game::onStreakBonus(double /*bonus*/)
 {
-   if (score > 6.0) {
-      mToonBoing1PlayerNode->start();
-   }
-   else if (score > 3.0) {
-      mToonBoing2PlayerNode->start();
-   }
-   else {
-      mToonBoing3PlayerNode->start();
-   }
+   playSound(mStreakBonusSound);
 }
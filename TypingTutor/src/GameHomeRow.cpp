@@ -25,11 +25,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "GameHomeRow.h"
 
-GameHomeRow::GameHomeRow(double duration) :
-Game(duration, 1.0)
+GameHomeRow::GameHomeRow(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog) :
+Game(GameRules::forSkill(Skill::HomeRow, duration, adaptiveFlag), layout, seed, assets, pSessionLog)
 {
-   mKb.loadImageFile("images/kb_home_row.png");
-   mKb.enableRow(2);
-   mMaxNbToons = 2;
-   mStreakMaxInc = 20;
-}
\ No newline at end of file
+}
@@ -25,13 +25,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "GameLetters.h"
 
-GameLetters::GameLetters(double duration) :
-Game(duration, 0.8)
+GameLetters::GameLetters(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog) :
+Game(GameRules::forSkill(Skill::Letters, duration, adaptiveFlag), layout, seed, assets, pSessionLog)
 {
-   mKb.loadImageFile("images/kb_letters.png");
-   mKb.enableRow(1);
-   mKb.enableRow(2);
-   mKb.enableRow(3);
-   mMaxNbToons = 3;
-   mStreakMaxInc = 40;
-}
\ No newline at end of file
+}
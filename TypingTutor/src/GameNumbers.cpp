@@ -25,14 +25,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "GameNumbers.h"
 
-GameNumbers::GameNumbers(double duration) :
-Game(duration, 0.6)
+GameNumbers::GameNumbers(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog) :
+Game(GameRules::forSkill(Skill::Numbers, duration, adaptiveFlag), layout, seed, assets, pSessionLog)
 {
-   mKb.loadImageFile("images/kb_numbers.png");
-   mKb.enableRow(0);
-   mKb.enableRow(1);
-   mKb.enableRow(2);
-   mKb.enableRow(3);
-   mMaxNbToons = 4;
-   mStreakMaxInc = 80;
-}
\ No newline at end of file
+}
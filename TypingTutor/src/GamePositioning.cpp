@@ -25,11 +25,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "GamePositioning.h"
 
-GamePositioning::GamePositioning(double duration) :
-Game(duration, 0.0)
+GamePositioning::GamePositioning(double duration, bool adaptiveFlag, const KeyboardLayout& layout, uint32_t seed, const AssetCacheRef& assets, SessionLog* pSessionLog) :
+Game(GameRules::forSkill(Skill::Positioning, duration, adaptiveFlag), layout, seed, assets, pSessionLog)
 {
-   mKb.loadImageFile("images/kb_positioning.png");
-   mKb.enableRow(2);
-   mKb.disableCol(4);
-   mKb.disableCol(5);
-}
\ No newline at end of file
+}
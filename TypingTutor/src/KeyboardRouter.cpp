@@ -0,0 +1,127 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "KeyboardRouter.h"
+
+#include "cinder/app/KeyEvent.h"
+#include "cinder/Log.h"
+
+#include <algorithm>
+
+#if defined( CINDER_MSW )
+#include <windows.h>
+#endif
+
+#if defined( CINDER_MSW )
+namespace {
+   const char* const WINDOW_CLASS = "TypingTutorKeyboardRouter";
+
+   LRESULT CALLBACK windowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+   {
+      if (message == WM_INPUT) {
+         auto pRouter = reinterpret_cast<KeyboardRouter*>(::GetWindowLongPtrA(hWnd, GWLP_USERDATA));
+         RAWINPUT input;
+         auto size = static_cast<UINT>(sizeof(input));
+         const auto nbBytes = ::GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER));
+         if (pRouter != nullptr && nbBytes != static_cast<UINT>(-1) && input.header.dwType == RIM_TYPEKEYBOARD) {
+            const auto& rKeyboard = input.data.keyboard;
+            const auto keyDownFlag = ((rKeyboard.Flags & RI_KEY_BREAK) == 0);
+            if (keyDownFlag && rKeyboard.VKey != 0xFF) { // 0xFF: part of an escaped sequence
+               pRouter->route(input.header.hDevice, ci::app::KeyEvent::translateNativeKeyCode(rKeyboard.VKey));
+            }
+         }
+      }
+      return ::DefWindowProcA(hWnd, message, wParam, lParam);
+   }
+}
+#endif
+
+KeyboardRouter::KeyboardRouter(int nbSeats, const Callback& callback) :
+mCallback(callback),
+mDevices(nbSeats, nullptr)
+{
+#if defined( CINDER_MSW )
+   // a message-only window, fed with the keys even when it has no focus
+   WNDCLASSEXA windowClass = {};
+   windowClass.cbSize = sizeof(windowClass);
+   windowClass.lpfnWndProc = windowProc;
+   windowClass.hInstance = ::GetModuleHandleA(nullptr);
+   windowClass.lpszClassName = WINDOW_CLASS;
+   ::RegisterClassExA(&windowClass);
+
+   const auto hWnd = ::CreateWindowExA(0, WINDOW_CLASS, "", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, windowClass.hInstance, nullptr);
+   if (hWnd == nullptr) {
+      CI_LOG_E("failed to create the raw input window");
+      return;
+   }
+   ::SetWindowLongPtrA(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+   RAWINPUTDEVICE device = {};
+   device.usUsagePage = 0x01; // generic desktop
+   device.usUsage = 0x06;     // keyboard
+   device.dwFlags = RIDEV_INPUTSINK;
+   device.hwndTarget = hWnd;
+   if (!::RegisterRawInputDevices(&device, 1, sizeof(device))) {
+      CI_LOG_E("failed to register for the raw keyboard input");
+      ::DestroyWindow(hWnd);
+      return;
+   }
+
+   mWindow = hWnd;
+#endif
+}
+
+KeyboardRouter::~KeyboardRouter()
+{
+#if defined( CINDER_MSW )
+   if (mWindow != nullptr) {
+      RAWINPUTDEVICE device = {};
+      device.usUsagePage = 0x01;
+      device.usUsage = 0x06;
+      device.dwFlags = RIDEV_REMOVE;
+      ::RegisterRawInputDevices(&device, 1, sizeof(device));
+      ::DestroyWindow(static_cast<HWND>(mWindow));
+   }
+#endif
+}
+
+void KeyboardRouter::route(void* device, int keyCode)
+{
+   if (device == nullptr) {
+      return; // injected by software, no keyboard to tell
+   }
+
+   auto it = std::find(mDevices.begin(), mDevices.end(), device);
+   if (it == mDevices.end()) {
+      it = std::find(mDevices.begin(), mDevices.end(), nullptr);
+      if (it == mDevices.end()) {
+         return; // more keyboards than seats
+      }
+      *it = device;
+      CI_LOG_I("keyboard " << device << " bound to seat " << (it - mDevices.begin()) + 1);
+   }
+
+   mCallback(static_cast<int>(it - mDevices.begin()), keyCode);
+}
@@ -0,0 +1,177 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "LatencyMonitor.h"
+#include "TextRenderer.h"
+
+#include "cinder/app/App.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#if defined( CINDER_MSW )
+#include <windows.h>
+#endif
+
+using namespace ci;
+
+const int LatencyMonitor::NB_BINS = 250; // the last bin takes everything slower
+const char* const LatencyMonitor::STAGE_NAMES[] = {
+   "queue",
+   "wait",
+   "render",
+   "total",
+};
+
+LatencyMonitor::LatencyMonitor() :
+mHistograms(static_cast<int>(Stage::Last), Histogram(NB_BINS, 0)),
+mMaxima(static_cast<int>(Stage::Last), 0.0)
+{
+}
+
+void LatencyMonitor::keyDown()
+{
+   const auto now = app::getElapsedSeconds();
+   auto arrival = now;
+
+#if defined( CINDER_MSW )
+   // the key message being handled was posted at GetMessageTime(), in ms of
+   // the same tick count as GetTickCount(); the difference wraps correctly
+   const auto queued = static_cast<DWORD>(::GetTickCount() - static_cast<DWORD>(::GetMessageTime()));
+   arrival -= 0.001 * queued;
+#endif
+
+   mDispatchedKeys.push_back({ arrival, now, 0.0 });
+}
+
+void LatencyMonitor::update()
+{
+   const auto now = app::getElapsedSeconds();
+
+   // the frame drawn last time is on screen now
+   for (const auto& rKey : mDrawnKeys) {
+      addSample(Stage::Queue, rKey.dispatch - rKey.arrival);
+      addSample(Stage::Wait, rKey.update - rKey.dispatch);
+      addSample(Stage::Render, now - rKey.update);
+      addSample(Stage::Total, now - rKey.arrival);
+   }
+   mDrawnKeys.clear();
+
+   for (auto& rKey : mDispatchedKeys) {
+      rKey.update = now;
+      mUpdatedKeys.push_back(rKey);
+   }
+   mDispatchedKeys.clear();
+}
+
+void LatencyMonitor::draw()
+{
+   mDrawnKeys.insert(mDrawnKeys.end(), mUpdatedKeys.cbegin(), mUpdatedKeys.cend());
+   mUpdatedKeys.clear();
+}
+
+void LatencyMonitor::addSample(Stage stage, double seconds)
+{
+   const auto iStage = static_cast<int>(stage);
+   const auto ms = std::max(1000.0 * seconds, 0.0);
+   const auto bin = std::min(static_cast<int>(ms), NB_BINS - 1);
+   ++mHistograms[iStage][bin];
+   mMaxima[iStage] = std::max(mMaxima[iStage], ms);
+}
+
+LatencyMonitor::Stats LatencyMonitor::computeStats(Stage stage) const
+{
+   const auto iStage = static_cast<int>(stage);
+   const auto& rHistogram = mHistograms[iStage];
+
+   Stats stats;
+   for (const auto n : rHistogram) { stats.count += n; }
+   if (stats.count == 0) {
+      return stats;
+   }
+
+   // the upper edge of the bin where the cumulated count reaches the quantile
+   const auto findQuantile = [&rHistogram, &stats](double q) {
+      const auto rank = q * stats.count;
+      auto cnt = 0;
+      for (size_t i = 0; i < rHistogram.size(); ++i) {
+         cnt += rHistogram[i];
+         if (cnt >= rank) {
+            return static_cast<double>(i + 1);
+         }
+      }
+      return static_cast<double>(rHistogram.size());
+   };
+
+   stats.p50 = findQuantile(0.5);
+   stats.p99 = findQuantile(0.99);
+   stats.max = mMaxima[iStage];
+   return stats;
+}
+
+void LatencyMonitor::drawHud(TextRenderer& rText, const vec2& pos) const
+{
+   const auto lineHeight = 22.0f;
+   auto linePos = pos;
+
+   rText.addString("key ms         p50    p99    max", linePos, 20.0f, ColorA(1, 1, 1, 1), ColorA(0, 0, 0, 0.7f), 0.5f);
+   for (auto i = 0; i < static_cast<int>(Stage::Last); ++i) {
+      const auto stats = computeStats(static_cast<Stage>(i));
+      std::ostringstream ss;
+      ss << std::left << std::setw(13) << STAGE_NAMES[i] << std::right << std::fixed << std::setprecision(1)
+         << std::setw(7) << stats.p50 << std::setw(7) << stats.p99 << std::setw(7) << stats.max;
+      linePos.y += lineHeight;
+      rText.addString(ss.str(), linePos, 20.0f, ColorA(1, 1, 1, 1), ColorA(0, 0, 0, 0.7f), 0.5f);
+   }
+}
+
+void LatencyMonitor::dump(const std::string& path) const
+{
+   std::ofstream ofs(path);
+   if (!ofs) {
+      throw std::runtime_error("cannot write " + path);
+   }
+
+   // the queue column comes from the system tick; it is only 10 to 16 ms fine
+   ofs << "ms";
+   for (auto i = 0; i < static_cast<int>(Stage::Last); ++i) {
+      ofs << "," << STAGE_NAMES[i];
+      if (static_cast<Stage>(i) == Stage::Queue) {
+         ofs << " (tick)";
+      }
+   }
+   ofs << "\n";
+
+   for (auto bin = 0; bin < NB_BINS; ++bin) {
+      ofs << bin;
+      for (const auto& rHistogram : mHistograms) {
+         ofs << "," << rHistogram[bin];
+      }
+      ofs << "\n";
+   }
+}
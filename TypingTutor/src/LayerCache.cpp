@@ -0,0 +1,58 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "LayerCache.h"
+
+#include "cinder/gl/gl.h"
+
+using namespace ci;
+
+void LayerCache::draw(const ivec2& size, const Painter& paint)
+{
+   if (size.x <= 0 || size.y <= 0) {
+      return; // minimized
+   }
+
+   if (!mFbo || mFbo->getSize() != size) {
+      mFbo = gl::Fbo::create(size.x, size.y, gl::Fbo::Format().disableDepth());
+      mValidFlag = false;
+   }
+
+   if (!mValidFlag) {
+      mValidFlag = true;
+      ++mRenderCount;
+
+      gl::ScopedFramebuffer scopedFbo(mFbo);
+      gl::ScopedViewport scopedViewport(ivec2(0), size);
+      gl::ScopedMatrices scopedMatrices;
+      gl::setMatricesWindow(size);
+      gl::clear(Color(0, 0, 0));
+      paint();
+   }
+
+   // the layer is opaque and covers the window; nothing to blend with
+   gl::ScopedBlend scopedBlend(false);
+   gl::draw(mFbo->getColorTexture(), Rectf(vec2(0), vec2(size)));
+}
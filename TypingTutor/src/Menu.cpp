@@ -25,12 +25,16 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "Menu.h"
 #include "cinder/app/KeyEvent.h"
+#include "cinder/Text.h"
+
+#include <algorithm>
 
 using namespace ci;
 using namespace ci::app;
 
 const Colorf Menu::GREEN = Colorf(75.0f / 255.0f, 170.0f / 255.0f, 66.0f / 255.0f);
 const Colorf Menu::YELLOW = Colorf(255.0f / 255.0f, 223.0f / 255.0f, 27.0f / 255.0f);
+const float Menu::BORDER = 30.0f;
 
 void Menu::update(TypingTutorInterface* pApp)
 {
@@ -41,7 +45,11 @@ void Menu::update(TypingTutorInterface* pApp)
 
       if (mKeyEscapeFlag) {
          mKeyEscapeFlag = false;
-         mSelectedOption = mSavedOption;
+         if (mSelectedOption != mSavedOption) {
+            invalidateLine(mSelectedOption);
+            invalidateLine(mSavedOption);
+            mSelectedOption = mSavedOption;
+         }
          pApp->goBackToPreviousState();
       }
       else {
@@ -51,37 +59,65 @@ void Menu::update(TypingTutorInterface* pApp)
    }
 }
 
-void Menu::draw(const TypingTutorInterface& rApp)
+void Menu::draw(TypingTutorInterface& rApp)
 {
-   TextLayout layout;
-   layout.clear(Color(0, 0, 0));
-   layout.setColor(GREEN);
-   layout.setFont(Font("Comic Sans MS", 48));
-   layout.setBorder(30, 30);
-   layout.addCenteredLine(mHeader);
+   updateTextures();
 
-   for (auto i = 0; i < mOptions.size(); ++i) {
-      addLine(i, &layout);
+   auto size = vec2(mHeaderTexture->getSize());
+   for (const auto& rTexture : mOptionTextures) {
+      size.x = std::max(size.x, static_cast<float>(rTexture->getWidth()));
+      size.y += rTexture->getHeight();
+   }
+   size += vec2(2.0f * BORDER);
+
+   const auto menuRect = Rectf(vec2(0), size).getCenteredFit(rApp.getWindowBounds(), false);
+   const auto scale = menuRect.getWidth() / size.x;
+
+   gl::color(Color(0, 0, 0));
+   gl::drawSolidRect(menuRect);
+   gl::color(Color(1, 1, 1));
+
+   // the header is centered, the options are left aligned, as a TextLayout would do
+   auto pos = vec2(0.5f * (size.x - mHeaderTexture->getWidth()), BORDER);
+   gl::draw(mHeaderTexture, Rectf(pos, pos + vec2(mHeaderTexture->getSize())).scaled(scale) + menuRect.getUpperLeft());
+   pos = vec2(BORDER, pos.y + mHeaderTexture->getHeight());
+   for (const auto& rTexture : mOptionTextures) {
+      gl::draw(rTexture, Rectf(pos, pos + vec2(rTexture->getSize())).scaled(scale) + menuRect.getUpperLeft());
+      pos.y += rTexture->getHeight();
    }
+}
 
-   mMenu = gl::Texture2d::create(layout.render(true, false));
+void Menu::updateTextures()
+{
+   if (!mHeaderTexture) {
+      mHeaderTexture = renderLine(mHeader, GREEN);
+   }
 
-   if (mMenu){
-      Rectf menuRect = Rectf(mMenu->getBounds()).getCenteredFit(rApp.getWindowBounds(), false);
-      gl::draw(mMenu, menuRect);
+   mOptionTextures.resize(mOptions.size());
+   for (auto i = 0; i < static_cast<int>(mOptions.size()); ++i) {
+      if (!mOptionTextures[i]) {
+         const auto& rColor = (mSelectedOption == i) ? YELLOW : GREEN;
+         mOptionTextures[i] = renderLine(mOptions[i], rColor);
+      }
    }
 }
 
-void Menu::addLine(int iOption, TextLayout* pLayout)
+gl::TextureRef Menu::renderLine(const std::string& line, const Colorf& color)
 {
-   if (mSelectedOption == iOption){
-      pLayout->setColor(YELLOW);
-   }
+   ++mRenderCount;
 
-   pLayout->addLine(mOptions[iOption]);
+   TextLayout layout;
+   layout.clear(Color(0, 0, 0));
+   layout.setColor(color);
+   layout.setFont(Font("Comic Sans MS", 48));
+   layout.addLine(line);
+   return gl::Texture2d::create(layout.render(true, false));
+}
 
-   if (mSelectedOption == iOption){
-      pLayout->setColor(GREEN);
+void Menu::invalidateLine(int iOption)
+{
+   if (0 <= iOption && iOption < static_cast<int>(mOptionTextures.size())) {
+      mOptionTextures[iOption].reset();
    }
 }
 
@@ -92,6 +128,7 @@ void Menu::keyDown(int code)
       mSelectionFlag = true;
    }
    else {
+      const auto previousOption = mSelectedOption;
       switch (code){
          case KeyEvent::KEY_DOWN    : ++mSelectedOption; break;
          case KeyEvent::KEY_UP      : --mSelectedOption; break;
@@ -101,5 +138,11 @@ void Menu::keyDown(int code)
       const auto NbOptions = static_cast<int>(mOptions.size());
       if (mSelectedOption < 0){ mSelectedOption = NbOptions - 1; }
       else if (mSelectedOption == NbOptions){ mSelectedOption = 0; }
+
+      // only the two lines whose highlight changed are rendered again
+      if (mSelectedOption != previousOption) {
+         invalidateLine(previousOption);
+         invalidateLine(mSelectedOption);
+      }
    }
 }
@@ -0,0 +1,197 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "ScreenCapture.h"
+#include "FileUtils.h"
+
+#include "cinder/gl/gl.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Log.h"
+#include "cinder/Surface.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <sstream>
+
+using namespace ci;
+
+ScreenCapture::ScreenCapture(const std::string& stem) :
+mStem(stem),
+mThread(&ScreenCapture::work, this)
+{
+}
+
+ScreenCapture::~ScreenCapture()
+{
+   // the images already read back are still written
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStopFlag = true;
+   }
+   mCondition.notify_all();
+   mThread.join();
+}
+
+void ScreenCapture::capture(const Area& area)
+{
+   if (mNextIndex < 0) {
+      mNextIndex = findFreeIndex(mStem, ".png");
+   }
+   std::ostringstream path;
+   path << mStem << mNextIndex++ << ".png";
+
+   Readback readback;
+   readback.size = area.getSize();
+   readback.path = path.str();
+
+   const auto nbBytes = static_cast<GLsizeiptr>(4 * readback.size.x * readback.size.y);
+   const auto it = std::find_if(mFreePbos.begin(), mFreePbos.end(),
+      [nbBytes](const gl::PboRef& pbo){ return pbo->getSize() == nbBytes; });
+   if (it != mFreePbos.end()) {
+      readback.pbo = *it;
+      mFreePbos.erase(it);
+   }
+   else {
+      readback.pbo = gl::Pbo::create(GL_PIXEL_PACK_BUFFER, nbBytes, nullptr, GL_STREAM_READ);
+   }
+
+   // with a pack buffer bound, glReadPixels returns at once and the GPU does the copy
+   {
+      gl::ScopedBuffer scopedPbo(readback.pbo);
+      glReadPixels(area.x1, area.y1, readback.size.x, readback.size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+   }
+   readback.sync = gl::Sync::create();
+
+   mReadbacks.push_back(readback);
+}
+
+void ScreenCapture::update()
+{
+   // the copies finish in order; stop at the first one still running
+   auto it = mReadbacks.begin();
+   for (; it != mReadbacks.end(); ++it) {
+      const auto status = it->sync->clientWaitSync(0, 0);
+      if (status == GL_TIMEOUT_EXPIRED) {
+         break;
+      }
+      if (status == GL_WAIT_FAILED) {
+         dropReadback(*it); // waiting on it again would hold back every later capture
+      }
+      else {
+         finishReadback(&*it);
+      }
+   }
+   mReadbacks.erase(mReadbacks.begin(), it);
+}
+
+void ScreenCapture::flush()
+{
+   for (auto& rReadback : mReadbacks) {
+      const auto status = rReadback.sync->clientWaitSync(GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+      if (status == GL_WAIT_FAILED) {
+         dropReadback(rReadback);
+      }
+      else {
+         finishReadback(&rReadback);
+      }
+   }
+   mReadbacks.clear();
+}
+
+void ScreenCapture::finishReadback(Readback* pReadback)
+{
+   Image image;
+   image.size = pReadback->size;
+   image.path = pReadback->path;
+   image.pixels.resize(pReadback->pbo->getSize());
+
+   auto mappedFlag = false;
+   {
+      gl::ScopedBuffer scopedPbo(pReadback->pbo);
+      const auto pData = pReadback->pbo->mapBufferRange(0, image.pixels.size(), GL_MAP_READ_BIT);
+      if (pData != nullptr) {
+         std::memcpy(image.pixels.data(), pData, image.pixels.size());
+         pReadback->pbo->unmap();
+         mappedFlag = true;
+      }
+   }
+   mFreePbos.push_back(pReadback->pbo);
+
+   if (!mappedFlag) {
+      CI_LOG_E("failed to read back " << image.path);
+      return;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mImages.push_back(std::move(image));
+   }
+   mCondition.notify_one();
+}
+
+void ScreenCapture::dropReadback(const Readback& rReadback)
+{
+   CI_LOG_E("failed to wait for the copy of " << rReadback.path << "; the screenshot is dropped");
+   mFreePbos.push_back(rReadback.pbo);
+}
+
+void ScreenCapture::work()
+{
+   while (true) {
+      Image image;
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+         mCondition.wait(lock, [this]{ return mStopFlag || !mImages.empty(); });
+         if (mImages.empty()) {
+            return; // stopped, and nothing left to write
+         }
+         image = std::move(mImages.front());
+         mImages.pop_front();
+      }
+
+      // GL rows go up from the bottom; the alpha of the window is dropped
+      const auto width = image.size.x;
+      const auto height = image.size.y;
+      Surface8u surface(width, height, false, SurfaceChannelOrder::RGB);
+      for (auto y = 0; y < height; ++y) {
+         const auto pSrc = image.pixels.data() + 4 * width * (height - 1 - y);
+         auto pDst = surface.getData(ivec2(0, y));
+         for (auto x = 0; x < width; ++x) {
+            pDst[3 * x + 0] = pSrc[4 * x + 0];
+            pDst[3 * x + 1] = pSrc[4 * x + 1];
+            pDst[3 * x + 2] = pSrc[4 * x + 2];
+         }
+      }
+
+      try {
+         writeImage(image.path, surface);
+      }
+      catch (std::exception& exc) {
+         CI_LOG_EXCEPTION("failed to write " << image.path, exc);
+      }
+   }
+}
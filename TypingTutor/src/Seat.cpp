@@ -0,0 +1,318 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "Seat.h"
+#include "MenuApp.h"
+#include "MenuSkill.h"
+#include "MenuDuration.h"
+#include "GamePositioning.h"
+#include "GameHomeRow.h"
+#include "GameLetters.h"
+#include "GameNumbers.h"
+#include "TextRenderer.h"
+#include "SpriteBatch.h"
+#include "AssetLoader.h"
+#include "FrameProfiler.h"
+#include "SessionLog.h"
+
+#include "cinder/app/App.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Log.h"
+#include "cinder/Rand.h"
+
+using namespace ci;
+using namespace ci::app;
+
+Seat::Seat(const WindowRef& window, const std::string& student, const Shared* pShared) :
+mSharedPtr(pShared),
+mWindow(window)
+{
+   assert(mWindow && mSharedPtr != nullptr);
+
+   mAppStates.resize(static_cast<int>(State::Last));
+   mAppStates[static_cast<int>(State::MenuApp     )].reset(new MenuApp     );
+   mAppStates[static_cast<int>(State::MenuSkill   )].reset(new MenuSkill   );
+   mAppStates[static_cast<int>(State::MenuDuration)].reset(new MenuDuration);
+
+   openSessionLog(student);
+
+   // the vertex arrays die with the GL context of the window, so go first
+   mCloseConnection = mWindow->getSignalClose().connect([this]() {
+      releaseRenderers();
+      mWindowClosedFlag = true;
+      mQuitFlag = true;
+   });
+
+   setState(State::MenuApp);
+}
+
+Seat::~Seat()
+{
+   releaseRenderers();
+}
+
+void Seat::openSessionLog(const std::string& student)
+{
+   try {
+      fs::create_directories("sessions");
+      mSessionLog.reset(new SessionLog("sessions/" + student + ".tts", [student](const std::string& message) {
+         CI_LOG_E("session log of " << student << ": " << message);
+      }));
+   }
+   catch (std::exception& exc) {
+      CI_LOG_E("failed to open the session log of " << student << ": " << exc.what());
+   }
+}
+
+void Seat::releaseRenderers()
+{
+   if (mSpriteBatch || mTextRenderer || mLayer) {
+      mWindow->getRenderer()->makeCurrentContext();
+      mSpriteBatch.reset();
+      mTextRenderer.reset();
+      mLayer.reset();
+   }
+}
+
+void Seat::update()
+{
+   if (mNewGamePendingFlag && mSharedPtr->pLoader->isDone()) {
+      setState(State::NewGame);
+   }
+
+   if (mAppStatePtr) {
+      mAppStatePtr->update(this);
+   }
+}
+
+void Seat::advance()
+{
+   if (auto pGame = getPlayedGame()) {
+      pGame->advance();
+   }
+}
+
+void Seat::endUpdate()
+{
+   if (auto pGame = getPlayedGame()) {
+      pGame->endUpdate();
+   }
+}
+
+Game* Seat::getPlayedGame() const
+{
+   // the game of the seat, if it is on screen rather than behind a menu
+   if (mCurrentGame == State::Last || mAppStatePtr != mAppStates[static_cast<int>(mCurrentGame)].get()) {
+      return nullptr;
+   }
+   return static_cast<Game*>(mAppStatePtr);
+}
+
+void Seat::draw()
+{
+   // made in the GL context of the window, current while it draws
+   if (!mSpriteBatch) {
+      mSpriteBatch.reset(new SpriteBatch);
+      mTextRenderer.reset(new TextRenderer(mSharedPtr->pFont));
+      mLayer.reset(new LayerCache);
+   }
+
+   if (mPositionWindowOnceFlag && mSharedPtr->background) {
+      mPositionWindowOnceFlag = false;
+      positionWindow();
+   }
+
+   if (mSharedPtr->background.get() != mLayerBgPtr) {
+      mLayerBgPtr = mSharedPtr->background.get();
+      mLayer->invalidate();
+   }
+
+   {
+      FrameProfiler::Scope bgScope(getProfiler(), FrameProfiler::Phase::Background);
+      mLayer->draw(getWindowSize(), [this]() {
+         drawBg();
+         if (mAppStatePtr) { mAppStatePtr->drawStatic(*this); }
+      });
+   }
+
+   if (mAppStatePtr) { mAppStatePtr->draw(*this); }
+}
+
+void Seat::positionWindow()
+{
+   // the size of the background, centered on the display of the window
+   mWindow->setSize(mSharedPtr->background->getSize());
+   const auto displaySize = mWindow->getDisplay()->getSize();
+   const auto displayPos = mWindow->getDisplay()->getBounds().getUL();
+   mWindow->setPos(displayPos + (displaySize - mWindow->getSize()) / 2);
+}
+
+void Seat::drawBg()
+{
+   const auto& rBg = mSharedPtr->background;
+   if (rBg) {
+      Rectf destRect = Rectf(rBg->getBounds()).getCenteredFit(getWindowBounds(), false);
+
+      const auto GameRunningNow = 
+         (mCurrentState == State::GamePosition ||
+          mCurrentState == State::GameHomeRow ||
+          mCurrentState == State::GameLetters ||
+          mCurrentState == State::GameNumbers);
+
+      if (GameRunningNow) { 
+         gl::color(ColorA(1.0f, 1.0f, 1.0f, 0.7f)); 
+      }
+
+      gl::draw(rBg, destRect);
+
+      if (GameRunningNow) { 
+         gl::color(Colorf(1.0f, 1.0f, 1.0f)); 
+      }
+   }
+}
+
+void Seat::keyDown(int code)
+{
+   if (mAppStatePtr) { 
+      mAppStatePtr->keyDown(code); 
+   }
+}
+
+void Seat::setState(State state)
+{
+   assert(state != State::Last);
+
+   // a round needs all of its assets; update() starts it once they have
+   // arrived, unless another state is chosen meanwhile
+   const auto pLoader = mSharedPtr->pLoader;
+   mNewGamePendingFlag = (state == State::NewGame && pLoader && !pLoader->isDone());
+   if (mNewGamePendingFlag) {
+      return;
+   }
+
+   mCurrentState = state;
+   if (mLayer) { mLayer->invalidate(); }
+   
+   switch (state) {
+      case State::NewGame : resetGame()           ; break;
+      case State::Continue: setState(mCurrentGame); break;
+      case State::Quit    : mQuitFlag = true      ; break;
+      default:
+         const auto iState = static_cast<int>(mCurrentState);
+         mAppStatePtr = mAppStates[iState].get();
+   }
+}
+
+void Seat::resetGame()
+{
+   if (mCurrentGame != State::Last) {
+      auto& rState = mAppStates[static_cast<int>(mCurrentGame)];
+      rState.reset(nullptr);
+   }
+
+   switch (mSkill) {
+      case Skill::Positioning: mCurrentGame = State::GamePosition; break;
+      case Skill::HomeRow    : mCurrentGame = State::GameHomeRow ; break;
+      case Skill::Letters    : mCurrentGame = State::GameLetters ; break;
+      case Skill::Numbers    : mCurrentGame = State::GameNumbers ; break;
+   }
+
+   auto& rState = mAppStates[static_cast<int>(mCurrentGame)];
+
+   // the game draws everything from its own generator; the seed is all a replay needs
+   const auto seed = Rand::randUint();
+   const auto& rLayout = mSharedPtr->layout;
+   const auto adaptiveFlag = mSharedPtr->adaptiveFlag;
+   const auto& rAssets = mSharedPtr->assets;
+
+   switch (mCurrentGame) {
+      case State::GamePosition: rState.reset(new GamePositioning(mGameDuration, adaptiveFlag, rLayout, seed, rAssets, mSessionLog.get())); break;
+      case State::GameHomeRow : rState.reset(new GameHomeRow    (mGameDuration, adaptiveFlag, rLayout, seed, rAssets, mSessionLog.get())); break;
+      case State::GameLetters : rState.reset(new GameLetters    (mGameDuration, adaptiveFlag, rLayout, seed, rAssets, mSessionLog.get())); break;
+      case State::GameNumbers : rState.reset(new GameNumbers    (mGameDuration, adaptiveFlag, rLayout, seed, rAssets, mSessionLog.get())); break;
+   }
+
+   setState(mCurrentGame);
+}
+
+void Seat::goBackToPreviousState()
+{
+   if (mCurrentState == State::MenuApp) {
+      if ( isGameRunning() ) {
+         setState(mCurrentGame);
+      }
+   }
+   else {
+      setState(State::MenuApp);
+   }
+}
+
+void Seat::setSkill(Skill skill)
+{
+   assert(skill != Skill::Last);
+   mSkill = skill;
+}
+
+void Seat::setGameDuration(double seconds)
+{
+   mGameDuration = seconds;
+}
+
+bool Seat::isGameRunning()
+{
+ return (mCurrentGame == State::GamePosition ||
+         mCurrentGame == State::GameHomeRow  || 
+         mCurrentGame == State::GameLetters  ||
+         mCurrentGame == State::GameNumbers);
+}
+
+ivec2 Seat::getWindowSize() const
+{
+   return mWindow->getSize();
+}
+
+TextRenderer& Seat::getTextRenderer()
+{
+   assert(mTextRenderer);
+   return *mTextRenderer;
+}
+
+SpriteBatch& Seat::getSpriteBatch()
+{
+   assert(mSpriteBatch);
+   return *mSpriteBatch;
+}
+
+FrameProfiler& Seat::getProfiler()
+{
+   assert(mSharedPtr->pProfiler != nullptr);
+   return *mSharedPtr->pProfiler;
+}
+
+ScreenCapture& Seat::getScreenCapture()
+{
+   assert(mSharedPtr->pScreenCapture != nullptr);
+   return *mSharedPtr->pScreenCapture;
+}
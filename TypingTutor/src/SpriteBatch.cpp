@@ -0,0 +1,195 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "SpriteBatch.h"
+
+#include <cmath>
+#include <cstddef>
+
+using namespace ci;
+
+namespace {
+
+   const char* VERTEX_SHADER = CI_GLSL(150,
+      uniform mat4 ciModelViewProjection;
+
+      in vec4 ciPosition;
+      in vec2 ciTexCoord0;
+      in vec2 aCenter;
+      in vec2 aSize;
+      in float aAngle;
+      in vec4 aUv;
+      in vec4 aTint;
+
+      out vec2 vTexCoord;
+      out vec4 vTint;
+
+      void main()
+      {
+         vec2 corner = ciPosition.xy * aSize;
+         float c = cos(aAngle);
+         float s = sin(aAngle);
+         vec2 pos = aCenter + vec2(c * corner.x - s * corner.y, s * corner.x + c * corner.y);
+         vTexCoord = mix(aUv.xy, aUv.zw, ciTexCoord0);
+         vTint = aTint;
+         gl_Position = ciModelViewProjection * vec4(pos, 0.0, 1.0);
+      }
+   );
+
+   const char* FRAGMENT_SHADER = CI_GLSL(150,
+      uniform sampler2D uTex0;
+
+      in vec2 vTexCoord;
+      in vec4 vTint;
+
+      out vec4 oColor;
+
+      void main()
+      {
+         oColor = texture(uTex0, vTexCoord) * vTint;
+      }
+   );
+
+   struct QuadVertex {
+      vec2 pos;
+      vec2 uv;
+   };
+
+   // two triangles of a unit quad centered on the origin
+   const QuadVertex QUAD[] = {
+      { vec2(-0.5f, -0.5f), vec2(0.0f, 0.0f) },
+      { vec2( 0.5f, -0.5f), vec2(1.0f, 0.0f) },
+      { vec2( 0.5f,  0.5f), vec2(1.0f, 1.0f) },
+      { vec2(-0.5f, -0.5f), vec2(0.0f, 0.0f) },
+      { vec2( 0.5f,  0.5f), vec2(1.0f, 1.0f) },
+      { vec2(-0.5f,  0.5f), vec2(0.0f, 1.0f) },
+   };
+
+   const GLsizei NB_QUAD_VERTICES = 6;
+}
+
+SpriteBatch::SpriteBatch()
+{
+   buildShader();
+}
+
+void SpriteBatch::buildShader()
+{
+   mShader = gl::GlslProg::create(VERTEX_SHADER, FRAGMENT_SHADER);
+   mShader->uniform("uTex0", 0);
+
+   mQuadVbo = gl::Vbo::create(GL_ARRAY_BUFFER, sizeof(QUAD), QUAD, GL_STATIC_DRAW);
+   mInstanceVbo = gl::Vbo::create(GL_ARRAY_BUFFER, 256 * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+   mVao = gl::Vao::create();
+
+   gl::ScopedVao vao(mVao);
+   gl::ScopedBuffer vbo(mQuadVbo);
+   setAttrib("ciPosition" , 2, offsetof(QuadVertex, pos), sizeof(QuadVertex));
+   setAttrib("ciTexCoord0", 2, offsetof(QuadVertex, uv ), sizeof(QuadVertex));
+}
+
+void SpriteBatch::setAttrib(const std::string& name, int nbComponents, size_t offset, size_t stride)
+{
+   const auto location = mShader->getAttribLocation(name);
+   if (location >= 0) {
+      gl::enableVertexAttribArray(location);
+      gl::vertexAttribPointer(location, nbComponents, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(stride), reinterpret_cast<const GLvoid*>(offset));
+   }
+}
+
+void SpriteBatch::setInstanceAttribs(size_t firstInstance)
+{
+   // the instance attributes point at the first instance of the run to draw
+   const auto base = firstInstance * sizeof(Instance);
+
+   gl::ScopedBuffer vbo(mInstanceVbo);
+   setAttrib("aCenter", 2, base + offsetof(Instance, center), sizeof(Instance));
+   setAttrib("aSize"  , 2, base + offsetof(Instance, size  ), sizeof(Instance));
+   setAttrib("aAngle" , 1, base + offsetof(Instance, angle ), sizeof(Instance));
+   setAttrib("aUv"    , 4, base + offsetof(Instance, uv    ), sizeof(Instance));
+   setAttrib("aTint"  , 4, base + offsetof(Instance, tint  ), sizeof(Instance));
+
+   for (const auto name : { "aCenter", "aSize", "aAngle", "aUv", "aTint" }) {
+      const auto location = mShader->getAttribLocation(name);
+      if (location >= 0) {
+         gl::vertexAttribDivisor(location, 1);
+      }
+   }
+}
+
+void SpriteBatch::addSprite(const gl::TextureRef& texture, const Rectf& uv, const vec2& center,
+   const vec2& size, float angle, const ColorA& tint)
+{
+   if (!texture) {
+      return;
+   }
+
+   Instance instance;
+   instance.center = center;
+   instance.size = size;
+   instance.angle = angle;
+   instance.uv = vec4(uv.x1, uv.y1, uv.x2, uv.y2);
+   instance.tint = tint;
+   mInstances.push_back(instance);
+
+   // a texture change starts a new draw, so later sprites still cover earlier ones
+   if (mRuns.empty() || mRuns.back().texture != texture) {
+      Run run;
+      run.texture = texture;
+      run.nbInstances = 0;
+      mRuns.push_back(run);
+   }
+   ++mRuns.back().nbInstances;
+}
+
+void SpriteBatch::draw()
+{
+   if (!mInstances.empty()) {
+      // orphan the previous frame's storage, then upload every run at once
+      const auto nbBytes = mInstances.size() * sizeof(Instance);
+      if (nbBytes > static_cast<size_t>(mInstanceVbo->getSize())) {
+         mInstanceVbo->bufferData(nbBytes, mInstances.data(), GL_STREAM_DRAW);
+      }
+      else {
+         mInstanceVbo->bufferData(mInstanceVbo->getSize(), nullptr, GL_STREAM_DRAW);
+         mInstanceVbo->bufferSubData(0, nbBytes, mInstances.data());
+      }
+
+      gl::ScopedGlslProg shader(mShader);
+      gl::ScopedVao vao(mVao);
+      gl::setDefaultShaderVars();
+
+      size_t firstInstance = 0;
+      for (const auto& rRun : mRuns) {
+         gl::ScopedTextureBind texture(rRun.texture, 0);
+         setInstanceAttribs(firstInstance);
+         gl::drawArraysInstanced(GL_TRIANGLES, 0, NB_QUAD_VERTICES, static_cast<GLsizei>(rRun.nbInstances));
+         firstInstance += rRun.nbInstances;
+      }
+   }
+
+   mInstances.clear();
+   mRuns.clear();
+}
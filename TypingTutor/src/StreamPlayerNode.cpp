@@ -0,0 +1,137 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "StreamPlayerNode.h"
+
+#include "cinder/Timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using namespace ci;
+
+const size_t StreamPlayerNode::CHUNK_FRAMES = 4096;
+
+StreamPlayerNode::StreamPlayerNode(const audio::SourceFileRef& sourceFile, double ringSeconds) :
+InputNode(Format().channels(sourceFile->getNumChannels())),
+mSourceFile(sourceFile),
+mChunk(CHUNK_FRAMES, sourceFile->getNumChannels())
+{
+   const auto ringFrames = static_cast<size_t>(ringSeconds * sourceFile->getSampleRate());
+   mRingFrames = std::max(ringFrames, 2 * CHUNK_FRAMES);
+}
+
+StreamPlayerNode::~StreamPlayerNode()
+{
+   // the thread must not outlive the members it writes to
+   mRunningFlag = false;
+   if (mThread.joinable()) {
+      mThread.join();
+   }
+}
+
+void StreamPlayerNode::initialize()
+{
+   mRingBuffers.clear();
+   for (size_t ch = 0; ch < mSourceFile->getNumChannels(); ++ch) {
+      mRingBuffers.emplace_back(new audio::dsp::RingBuffer(mRingFrames));
+   }
+
+   // prefill so the first blocks do not underrun
+   while (decodeChunk()) {
+      ;
+   }
+
+   mRunningFlag = true;
+   mThread = std::thread(&StreamPlayerNode::decode, this);
+}
+
+void StreamPlayerNode::uninitialize()
+{
+   mRunningFlag = false;
+   if (mThread.joinable()) {
+      mThread.join();
+   }
+}
+
+bool StreamPlayerNode::decodeChunk()
+{
+   for (const auto& rRing : mRingBuffers) {
+      if (rRing->getAvailableWrite() < CHUNK_FRAMES) {
+         return false; // the ring is full enough
+      }
+   }
+
+   Timer timer(true);
+
+   auto nbFrames = mSourceFile->read(&mChunk);
+   if (nbFrames < CHUNK_FRAMES) {
+      // end of file: start over, the next chunk continues right after this one
+      mSourceFile->seek(0);
+      if (nbFrames == 0) {
+         nbFrames = mSourceFile->read(&mChunk);
+      }
+   }
+
+   for (size_t ch = 0; ch < mRingBuffers.size(); ++ch) {
+      mRingBuffers[ch]->write(mChunk.getChannel(ch), nbFrames);
+   }
+
+   mDecodeMicroseconds += static_cast<long long>(1.0e6 * timer.getSeconds());
+   return (nbFrames > 0);
+}
+
+void StreamPlayerNode::decode()
+{
+   while (mRunningFlag) {
+      if (!decodeChunk()) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+   }
+}
+
+void StreamPlayerNode::process(audio::Buffer* buffer)
+{
+   const auto nbFrames = buffer->getNumFrames();
+   for (size_t ch = 0; ch < buffer->getNumChannels(); ++ch) {
+      auto& rRing = mRingBuffers[std::min(ch, mRingBuffers.size() - 1)];
+      if (!rRing->read(buffer->getChannel(ch), nbFrames)) {
+         // the decoder fell behind; play silence rather than stale samples
+         std::fill(buffer->getChannel(ch), buffer->getChannel(ch) + nbFrames, 0.0f);
+         ++mUnderruns;
+      }
+   }
+}
+
+std::string StreamPlayerNode::getReport() const
+{
+   std::ostringstream ss;
+   ss << "sound track: ring buffers " << getRingBytes() / 1024 << " KiB"
+      << " (a full decode would take " << getFullDecodeBytes() / 1024 << " KiB)"
+      << ", decoded in " << getDecodeSeconds() << " s"
+      << ", " << getUnderruns() << " underruns";
+   return ss.str();
+}
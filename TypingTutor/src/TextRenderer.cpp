@@ -0,0 +1,389 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "TextRenderer.h"
+
+#include "cinder/Text.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+using namespace ci;
+
+const int TextRenderer::FIRST_CHAR = 32;
+const int TextRenderer::LAST_CHAR = 126;
+const int TextRenderer::ATLAS_WIDTH = 1024;
+const float TextRenderer::GLYPH_SIZE = 64.0f;
+const float TextRenderer::SPREAD = 8.0f;
+
+namespace {
+
+   const char* VERTEX_SHADER = CI_GLSL(150,
+      uniform mat4 ciModelViewProjection;
+
+      in vec4 ciPosition;
+      in vec2 ciTexCoord0;
+      in vec4 ciColor;
+      in vec4 aOutlineColor;
+      in float aOutlineEdge;
+
+      out vec2 vTexCoord;
+      out vec4 vColor;
+      out vec4 vOutlineColor;
+      out float vOutlineEdge;
+
+      void main()
+      {
+         vTexCoord = ciTexCoord0;
+         vColor = ciColor;
+         vOutlineColor = aOutlineColor;
+         vOutlineEdge = aOutlineEdge;
+         gl_Position = ciModelViewProjection * ciPosition;
+      }
+   );
+
+   const char* FRAGMENT_SHADER = CI_GLSL(150,
+      uniform sampler2D uAtlas;
+
+      in vec2 vTexCoord;
+      in vec4 vColor;
+      in vec4 vOutlineColor;
+      in float vOutlineEdge;
+
+      out vec4 oColor;
+
+      void main()
+      {
+         float d = texture(uAtlas, vTexCoord).r;
+         float w = max(fwidth(d), 0.001);
+         float fill = smoothstep(0.5 - w, 0.5 + w, d);
+         float outline = smoothstep(vOutlineEdge - w, vOutlineEdge + w, d);
+         vec4 outer = vec4(vOutlineColor.rgb, vOutlineColor.a * outline);
+         oColor = mix(outer, vColor, fill);
+      }
+   );
+
+   struct Offset {
+      int dx;
+      int dy;
+      int distSq() const { return dx * dx + dy * dy; }
+   };
+
+   using VOffset = std::vector<Offset>;
+
+   const Offset FAR_AWAY = { 9999, 9999 };
+
+   void compare(VOffset* pGrid, int w, int h, int x, int y, int ox, int oy)
+   {
+      auto other = FAR_AWAY;
+      if (0 <= x + ox && x + ox < w && 0 <= y + oy && y + oy < h) {
+         other = (*pGrid)[(y + oy) * w + x + ox];
+      }
+      other.dx += ox;
+      other.dy += oy;
+
+      auto& rCurrent = (*pGrid)[y * w + x];
+      if (other.distSq() < rCurrent.distSq()) {
+         rCurrent = other;
+      }
+   }
+
+   // 8-points signed sequential Euclidean distance transform.
+   void sweep(VOffset* pGrid, int w, int h)
+   {
+      for (auto y = 0; y < h; ++y) {
+         for (auto x = 0; x < w; ++x) {
+            compare(pGrid, w, h, x, y, -1,  0);
+            compare(pGrid, w, h, x, y,  0, -1);
+            compare(pGrid, w, h, x, y, -1, -1);
+            compare(pGrid, w, h, x, y,  1, -1);
+         }
+         for (auto x = w - 1; x >= 0; --x) {
+            compare(pGrid, w, h, x, y, 1, 0);
+         }
+      }
+
+      for (auto y = h - 1; y >= 0; --y) {
+         for (auto x = w - 1; x >= 0; --x) {
+            compare(pGrid, w, h, x, y,  1, 0);
+            compare(pGrid, w, h, x, y,  0, 1);
+            compare(pGrid, w, h, x, y, -1, 1);
+            compare(pGrid, w, h, x, y,  1, 1);
+         }
+         for (auto x = 0; x < w; ++x) {
+            compare(pGrid, w, h, x, y, -1, 0);
+         }
+      }
+   }
+
+   // Returns the distance field of the glyph coverage, padded by spread on every side.
+   Channel8u generateSdf(const Channel8u& coverage, int spread)
+   {
+      const auto w = coverage.getWidth() + 2 * spread;
+      const auto h = coverage.getHeight() + 2 * spread;
+
+      VOffset inside(w * h, FAR_AWAY);
+      VOffset outside(w * h, FAR_AWAY);
+      for (auto y = 0; y < h; ++y) {
+         for (auto x = 0; x < w; ++x) {
+            const auto cx = x - spread;
+            const auto cy = y - spread;
+            const auto covered =
+               (0 <= cx && cx < coverage.getWidth() && 0 <= cy && cy < coverage.getHeight()) &&
+               (coverage.getValue(ivec2(cx, cy)) > 127);
+            const Offset zero = { 0, 0 };
+            if (covered) { inside[y * w + x] = zero; }
+            else { outside[y * w + x] = zero; }
+         }
+      }
+
+      sweep(&inside, w, h);
+      sweep(&outside, w, h);
+
+      Channel8u sdf(w, h);
+      for (auto y = 0; y < h; ++y) {
+         for (auto x = 0; x < w; ++x) {
+            const auto i = y * w + x;
+            const auto dist = std::sqrt(static_cast<float>(outside[i].distSq())) -
+                              std::sqrt(static_cast<float>(inside[i].distSq()));
+            const auto value = 0.5f + 0.5f * dist / spread;
+            *sdf.getData(ivec2(x, y)) = static_cast<uint8_t>(255.0f * std::min(std::max(value, 0.0f), 1.0f));
+         }
+      }
+      return sdf;
+   }
+}
+
+TextRenderer::TextRenderer(const std::string& fontName)
+{
+   buildAtlas(fontName);
+   buildShader();
+   buildBuffers();
+}
+
+TextRenderer::TextRenderer(const TextRenderer* pFont) :
+mLineHeight(pFont->mLineHeight),
+mGlyphs(pFont->mGlyphs),
+mAtlas(pFont->mAtlas),
+mShader(pFont->mShader)
+{
+   buildBuffers();
+}
+
+void TextRenderer::buildAtlas(const std::string& fontName)
+{
+   const Font font(fontName, GLYPH_SIZE);
+   const auto spread = static_cast<int>(SPREAD);
+
+   std::vector<Channel8u> fields;
+   for (auto c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+      TextLayout layout;
+      layout.clear(ColorA(0, 0, 0, 0));
+      layout.setColor(Color(1, 1, 1));
+      layout.setFont(font);
+      layout.addLine(std::string(1, static_cast<char>(c)));
+      auto surface = layout.render(true, false);
+
+      Glyph glyph;
+      glyph.advance = static_cast<float>(surface.getWidth());
+      if (c == ' ' && glyph.advance <= 1.0f) {
+         glyph.advance = 0.3f * GLYPH_SIZE;
+      }
+      mLineHeight = std::max(mLineHeight, static_cast<float>(surface.getHeight()));
+
+      fields.push_back(generateSdf(surface.getChannelAlpha(), spread));
+      glyph.size = vec2(fields.back().getSize());
+      mGlyphs.push_back(glyph);
+   }
+
+   // shelf packing; all the glyphs share the same line height
+   std::vector<ivec2> positions;
+   auto pen = ivec2(0, 0);
+   auto shelfHeight = 0;
+   for (const auto& rField : fields) {
+      if (pen.x + rField.getWidth() > ATLAS_WIDTH) {
+         pen = ivec2(0, pen.y + shelfHeight);
+         shelfHeight = 0;
+      }
+      positions.push_back(pen);
+      pen.x += rField.getWidth();
+      shelfHeight = std::max(shelfHeight, rField.getHeight());
+   }
+   const auto atlasHeight = pen.y + shelfHeight;
+
+   Channel8u atlas(ATLAS_WIDTH, atlasHeight);
+   std::fill(atlas.getData(), atlas.getData() + atlas.getRowBytes() * atlasHeight, static_cast<uint8_t>(0));
+   for (auto i = 0; i < static_cast<int>(fields.size()); ++i) {
+      const auto& rField = fields[i];
+      atlas.copyFrom(rField, rField.getBounds(), positions[i]);
+
+      const auto topLeft = vec2(positions[i]) / vec2(atlas.getSize());
+      const auto bottomRight = vec2(positions[i] + rField.getSize()) / vec2(atlas.getSize());
+      mGlyphs[i].uv = Rectf(topLeft, bottomRight);
+   }
+
+   auto format = gl::Texture2d::Format().minFilter(GL_LINEAR).magFilter(GL_LINEAR).wrap(GL_CLAMP_TO_EDGE);
+   mAtlas = gl::Texture2d::create(atlas, format);
+}
+
+void TextRenderer::buildShader()
+{
+   mShader = gl::GlslProg::create(VERTEX_SHADER, FRAGMENT_SHADER);
+   mShader->uniform("uAtlas", 0);
+}
+
+void TextRenderer::buildBuffers()
+{
+   // the vertex array belongs to the GL context current now
+   mVbo = gl::Vbo::create(GL_ARRAY_BUFFER, 1024 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+   mVao = gl::Vao::create();
+
+   gl::ScopedVao vao(mVao);
+   gl::ScopedBuffer vbo(mVbo);
+   setAttrib("ciPosition"   , 2, offsetof(Vertex, pos         ));
+   setAttrib("ciTexCoord0"  , 2, offsetof(Vertex, uv          ));
+   setAttrib("ciColor"      , 4, offsetof(Vertex, color       ));
+   setAttrib("aOutlineColor", 4, offsetof(Vertex, outlineColor));
+   setAttrib("aOutlineEdge" , 1, offsetof(Vertex, outlineEdge ));
+}
+
+void TextRenderer::setAttrib(const std::string& name, int nbComponents, size_t offset)
+{
+   const auto location = mShader->getAttribLocation(name);
+   if (location >= 0) {
+      gl::enableVertexAttribArray(location);
+      gl::vertexAttribPointer(location, nbComponents, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const GLvoid*>(offset));
+   }
+}
+
+const TextRenderer::Glyph& TextRenderer::getGlyph(char c) const
+{
+   const auto i = static_cast<unsigned char>(c);
+   if (i < FIRST_CHAR || i > LAST_CHAR) {
+      return mGlyphs['?' - FIRST_CHAR];
+   }
+   return mGlyphs[i - FIRST_CHAR];
+}
+
+float TextRenderer::measureLine(const std::string& str, size_t begin, size_t end) const
+{
+   auto width = 0.0f;
+   for (auto i = begin; i < end; ++i) {
+      width += getGlyph(str[i]).advance;
+   }
+   return width;
+}
+
+float TextRenderer::measureWidth(const std::string& str, float size) const
+{
+   auto width = 0.0f;
+   size_t begin = 0;
+   while (begin <= str.size()) {
+      auto end = str.find('\n', begin);
+      if (end == std::string::npos) { end = str.size(); }
+      width = std::max(width, measureLine(str, begin, end));
+      begin = end + 1;
+   }
+   return width * size / GLYPH_SIZE;
+}
+
+void TextRenderer::addText(const std::string& str, const vec2& pos, float size, Align align,
+   const ColorA& color, const ColorA& outlineColor, float outlineWidth)
+{
+   const auto scale = size / GLYPH_SIZE;
+   const auto outlineEdge = std::max(0.5f - 0.5f * outlineWidth / (scale * SPREAD), 0.0f);
+
+   auto lineTop = pos.y;
+   size_t begin = 0;
+   while (begin <= str.size()) {
+      auto end = str.find('\n', begin);
+      if (end == std::string::npos) { end = str.size(); }
+
+      auto x = pos.x;
+      const auto width = scale * measureLine(str, begin, end);
+      switch (align) {
+         case Align::Left  :                    break;
+         case Align::Center: x -= 0.5f * width; break;
+         case Align::Right : x -= width;        break;
+      }
+
+      for (auto i = begin; i < end; ++i) {
+         const auto& rGlyph = getGlyph(str[i]);
+         addGlyph(rGlyph, vec2(x, lineTop), scale, color, outlineColor, outlineEdge);
+         x += scale * rGlyph.advance;
+      }
+
+      lineTop += scale * mLineHeight;
+      begin = end + 1;
+   }
+}
+
+void TextRenderer::addGlyph(const Glyph& glyph, const vec2& topLeft, float scale,
+   const ColorA& color, const ColorA& outlineColor, float outlineEdge)
+{
+   const auto p1 = topLeft - vec2(scale * SPREAD);
+   const auto p2 = p1 + scale * glyph.size;
+   const auto& uv = glyph.uv;
+
+   Vertex v;
+   v.color = color;
+   v.outlineColor = outlineColor;
+   v.outlineEdge = outlineEdge;
+
+   v.pos = p1                ; v.uv = uv.getUpperLeft() ; mVertices.push_back(v);
+   v.pos = vec2(p2.x, p1.y)  ; v.uv = uv.getUpperRight(); mVertices.push_back(v);
+   v.pos = p2                ; v.uv = uv.getLowerRight(); mVertices.push_back(v);
+   v.pos = p1                ; v.uv = uv.getUpperLeft() ; mVertices.push_back(v);
+   v.pos = p2                ; v.uv = uv.getLowerRight(); mVertices.push_back(v);
+   v.pos = vec2(p1.x, p2.y)  ; v.uv = uv.getLowerLeft() ; mVertices.push_back(v);
+}
+
+void TextRenderer::draw()
+{
+   if (mVertices.empty()) {
+      return;
+   }
+
+   gl::ScopedGlslProg shader(mShader);
+   gl::ScopedTextureBind texture(mAtlas, 0);
+   gl::ScopedVao vao(mVao);
+   gl::ScopedBuffer vbo(mVbo);
+
+   // orphan the previous frame's storage, then upload this frame's strings
+   const auto nbBytes = mVertices.size() * sizeof(Vertex);
+   if (nbBytes > static_cast<size_t>(mVbo->getSize())) {
+      mVbo->bufferData(nbBytes, mVertices.data(), GL_STREAM_DRAW);
+   }
+   else {
+      mVbo->bufferData(mVbo->getSize(), nullptr, GL_STREAM_DRAW);
+      mVbo->bufferSubData(0, nbBytes, mVertices.data());
+   }
+
+   gl::setDefaultShaderVars();
+   gl::drawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(mVertices.size()));
+
+   mVertices.clear();
+}
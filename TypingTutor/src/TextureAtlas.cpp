@@ -0,0 +1,117 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace ci;
+
+const int TextureAtlas::PAGE_SIZE = 2048;
+const int TextureAtlas::PADDING = 2;
+
+TextureAtlas::RegionRef TextureAtlas::add(const Surface& surface)
+{
+   Entry entry;
+   entry.surface = surface;
+   entry.region = std::make_shared<Region>();
+   entry.region->size = vec2(surface.getSize());
+   mEntries.push_back(entry);
+   return entry.region;
+}
+
+void TextureAtlas::packEntries(std::vector<ivec2>* pPageSizes)
+{
+   assert(pPageSizes != nullptr);
+
+   // shelf packing, tallest images first so each shelf wastes little height
+   std::vector<int> order(mEntries.size());
+   std::iota(order.begin(), order.end(), 0);
+   std::sort(order.begin(), order.end(), [this](int a, int b) {
+      return mEntries[a].surface.getHeight() > mEntries[b].surface.getHeight();
+   });
+
+   auto pen = ivec2(0, 0);
+   auto shelfHeight = 0;
+   auto page = -1;
+
+   for (const auto i : order) {
+      auto& rEntry = mEntries[i];
+      const auto size = rEntry.surface.getSize() + ivec2(PADDING);
+
+      if (page < 0 || pen.x + size.x > PAGE_SIZE) {
+         pen = ivec2(0, pen.y + shelfHeight);
+         shelfHeight = 0;
+      }
+      if (page < 0 || pen.y + size.y > PAGE_SIZE) {
+         pen = ivec2(0, 0);
+         pPageSizes->emplace_back(0, 0);
+         ++page;
+      }
+
+      rEntry.pos = pen;
+      rEntry.page = page;
+
+      // pages are trimmed to their content; an image bigger than a page stretches it
+      auto& rPageSize = pPageSizes->back();
+      rPageSize = glm::max(rPageSize, pen + size);
+
+      pen.x += size.x;
+      shelfHeight = std::max(shelfHeight, size.y);
+   }
+}
+
+void TextureAtlas::build()
+{
+   std::vector<ivec2> pageSizes;
+   packEntries(&pageSizes);
+
+   std::vector<Surface> surfaces;
+   for (const auto& rSize : pageSizes) {
+      surfaces.emplace_back(rSize.x, rSize.y, true);
+      auto& rSurface = surfaces.back();
+      std::fill(rSurface.getData(), rSurface.getData() + rSurface.getRowBytes() * rSurface.getHeight(), static_cast<uint8_t>(0));
+   }
+
+   for (const auto& rEntry : mEntries) {
+      surfaces[rEntry.page].copyFrom(rEntry.surface, rEntry.surface.getBounds(), rEntry.pos);
+   }
+
+   const auto firstPage = static_cast<int>(mPages.size());
+   for (const auto& rSurface : surfaces) {
+      mPages.push_back(gl::Texture2d::create(rSurface));
+   }
+
+   for (auto& rEntry : mEntries) {
+      const auto& rTexture = mPages[firstPage + rEntry.page];
+      const auto area = Area(rEntry.pos, rEntry.pos + rEntry.surface.getSize());
+      rEntry.region->texture = rTexture;
+      rEntry.region->uv = rTexture->getAreaTexCoords(area);
+   }
+
+   // the surfaces are in video memory now; later additions go to new pages
+   mEntries.clear();
+}
@@ -23,91 +23,223 @@ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
 TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
+#include "cinder/app/App.h"
 #include "cinder/app/RendererGl.h"
 #include "cinder/gl/gl.h"
 #include "cinder/Log.h"
 #include "cinder/audio/audio.h"
 #include "cinder/Rand.h"
 
-#include "TypingTutorInterface.h"
-#include "MenuApp.h"
-#include "MenuSkill.h"
-#include "MenuDuration.h"
-#include "GamePositioning.h"
-#include "GameHomeRow.h"
-#include "GameLetters.h"
-#include "GameNumbers.h"
+#include "Seat.h"
+#include "TextRenderer.h"
+#include "AssetCache.h"
+#include "AssetLoader.h"
+#include "StreamPlayerNode.h"
+#include "FrameProfiler.h"
+#include "LatencyMonitor.h"
+#include "FileUtils.h"
+#include "ScreenCapture.h"
+#include "KeyboardLayout.h"
+#include "KeyboardRouter.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
 
 using namespace ci;
 using namespace ci::app;
 
-class TypingTutorApp : public TypingTutorInterface {
+// Runs one seat per window. By default there is one seat, on the main
+// window; TypingTutor --seats=4 opens a window per seat, spread over the
+// displays, each one played with its own keyboard. The seats share the
+// assets, the sound and the font, and their games advance in parallel.
+class TypingTutorApp : public App {
   public:
    virtual ~TypingTutorApp() = default;
 
 	virtual void setup() override;
 	virtual void update() override;
 	virtual void draw() override;
+   virtual void cleanup() override;
    virtual void keyDown(KeyEvent event) override;
 
-   virtual void setState(State state) override final;
-   virtual void goBackToPreviousState() override final;
-   virtual void setSkill(Skill skill) override final;
-   virtual void setGameDuration(double seconds) override final;
-   virtual bool isGameRunning() override final;
-
    private:
-      using UniqueAppState = std::unique_ptr<AppState>;
-      using VUniqueAppState = std::vector<UniqueAppState>;
-
-      void drawBg();
-      void setupSoundTrack();
-      void resetGame();
-
-      bool mPositionWindowOnceFlag{ true };
-      gl::TextureRef mBg;
+      using UniqueSeat = std::unique_ptr<Seat>;
+      using VUniqueSeat = std::vector<UniqueSeat>;
+      using VString = std::vector<std::string>;
+
+      void drawProgress();
+      bool isLoadingMenu() const;
+      void loadMenuAssets();
+      void setupSoundTrack(const audio::SourceFileRef& soundTrackFile);
+      void loadLayout();
+      void openSeats();
+      VString getStudents(int nbSeats) const;
+      void closeQuittingSeats();
+      Seat* findSeat(const WindowRef& window) const;
+      void handleKey(Seat* pSeat, int code);
+      void dumpProfile();
+
+      std::unique_ptr<TextRenderer> mFont;
+      std::unique_ptr<FrameProfiler> mProfiler;
+      std::unique_ptr<LatencyMonitor> mLatency;
+      std::unique_ptr<ScreenCapture> mScreenCapture;
+      std::unique_ptr<AssetLoader> mLoader;
+      std::unique_ptr<WorkerPool> mPool;
+      std::unique_ptr<KeyboardRouter> mRouter;
       audio::GainNodeRef mSoundTrackGain;
-      audio::BufferPlayerNodeRef mSoundTrackPlayerNode;
-      std::unique_ptr<AppState> mMenu;
-      AppState* mAppStatePtr{ nullptr };
-      State mCurrentState{ State::Last };
-      VUniqueAppState mAppStates;
-      double mGameDuration{ 180.0 };
-      Skill mSkill{ Skill::Positioning };
-      State mCurrentGame{ State::Last };
+      StreamPlayerNodeRef mSoundTrackPlayerNode;
+      Seat::Shared mShared;
+      VUniqueSeat mSeats; // by seat; a closed seat is null
 };
 
 void TypingTutorApp::setup()
 {
+   mProfiler.reset(new FrameProfiler);
+   mLatency.reset(new LatencyMonitor);
+   mScreenCapture.reset(new ScreenCapture("screens/tt"));
+
+   // the layout picks the keyboard images to preload
+   loadLayout();
+
    try {
-      mBg = gl::Texture::create(loadImage(L"images/background.png"));
-      setupSoundTrack();
-      
-      mAppStates.clear();
-      mAppStates.resize(static_cast<int>(State::Last));
-      mAppStates[static_cast<int>(State::MenuApp     )].reset(new MenuApp                       );
-      mAppStates[static_cast<int>(State::MenuSkill   )].reset(new MenuSkill                     );
-      mAppStates[static_cast<int>(State::MenuDuration)].reset(new MenuDuration                  );
+      mFont.reset(new TextRenderer("Comic Sans MS"));
+      mShared.assets = std::make_shared<AssetCache>();
+      mLoader.reset(new AssetLoader);
+
+      // the menu assets are queued first; the game assets follow in the background
+      loadMenuAssets();
+      mShared.assets->preload(mShared.layout, mLoader.get());
    }
    catch (Exception &exc) {
       CI_LOG_EXCEPTION("failed to load resources.", exc);
    }
 
+   // TypingTutor --adaptive spawns more toons on the keys the student is weak on
+   const auto& args = getCommandLineArgs();
+   mShared.adaptiveFlag = (std::find(args.begin(), args.end(), "--adaptive") != args.end());
+
+   mShared.pLoader = mLoader.get();
+   mShared.pProfiler = mProfiler.get();
+   mShared.pScreenCapture = mScreenCapture.get();
+   mShared.pFont = mFont.get();
+
    Rand::randomize();
 
-   setState(State::MenuApp);
+   openSeats();
+}
+
+void TypingTutorApp::openSeats()
+{
+   // TypingTutor --seats=4 --student=alice,bob,carol,dave
+   auto nbSeats = 1;
+   const std::string option("--seats=");
+   for (const auto& arg : getCommandLineArgs()) {
+      if (arg.compare(0, option.size(), option) == 0) {
+         nbSeats = std::max(std::atoi(arg.substr(option.size()).c_str()), 1);
+      }
+   }
+
+   const auto students = getStudents(nbSeats);
+   const auto& rDisplays = Display::getDisplays();
+   for (auto i = 0; i < nbSeats; ++i) {
+      auto window = getWindow();
+      if (i > 0) {
+         const auto format = Window::Format().display(rDisplays[i % rDisplays.size()]).size(getWindowSize()).resizable(false);
+         window = createWindow(format);
+      }
+      if (nbSeats > 1) {
+         std::ostringstream title;
+         title << "TypingTutor - seat " << i + 1 << " (" << students[i] << ")";
+         window->setTitle(title.str());
+      }
+      mSeats.emplace_back(new Seat(window, students[i], &mShared));
+   }
+
+   // the caller of run() is one of the threads
+   const auto nbCores = static_cast<int>(std::thread::hardware_concurrency());
+   mPool.reset(new WorkerPool(std::max(std::min(nbSeats, nbCores) - 1, 0)));
+
+   if (nbSeats > 1) {
+      mRouter.reset(new KeyboardRouter(nbSeats, [this](int seat, int code) {
+         handleKey(mSeats[seat].get(), code);
+      }));
+      if (!mRouter->isActive()) {
+         CI_LOG_W("the keyboards cannot be told apart; the keys go to the focused window");
+      }
+   }
+}
+
+TypingTutorApp::VString TypingTutorApp::getStudents(int nbSeats) const
+{
+   // TypingTutor --student=alice appends the games to sessions/alice.tts
+   VString students;
+   const std::string option("--student=");
+   for (const auto& arg : getCommandLineArgs()) {
+      if (arg.compare(0, option.size(), option) == 0) {
+         std::istringstream ss(arg.substr(option.size()));
+         std::string student;
+         students.clear();
+         while (std::getline(ss, student, ',')) {
+            students.push_back(student);
+         }
+      }
+   }
+
+   // a log is written by one seat only
+   students.resize(nbSeats);
+   for (auto i = 0; i < nbSeats; ++i) {
+      auto& rStudent = students[i];
+      if (rStudent.empty()) {
+         rStudent = (nbSeats > 1) ? "student" + std::to_string(i + 1) : "student";
+      }
+      if (std::find(students.begin(), students.begin() + i, rStudent) != students.begin() + i) {
+         rStudent += "-" + std::to_string(i + 1);
+      }
+   }
+   return students;
 }
 
-void TypingTutorApp::setupSoundTrack()
+void TypingTutorApp::loadLayout()
+{
+   // TypingTutor --layout=layouts/azerty.txt; QWERTY otherwise
+   const std::string option("--layout=");
+   for (const auto& arg : getCommandLineArgs()) {
+      if (arg.compare(0, option.size(), option) == 0) {
+         try {
+            mShared.layout = KeyboardLayout::load(arg.substr(option.size()));
+            CI_LOG_I("keyboard layout " << mShared.layout.name);
+         }
+         catch (std::exception& exc) {
+            CI_LOG_E("failed to load the keyboard layout: " << exc.what());
+         }
+      }
+   }
+}
+
+void TypingTutorApp::loadMenuAssets()
+{
+   mLoader->enqueue([this]() -> AssetLoader::Finalizer {
+      const auto surface = Surface(loadImage(L"images/background.png"));
+      return [this, surface]() { mShared.background = gl::Texture::create(surface); };
+   });
+
+   const auto sampleRate = audio::Context::master()->getSampleRate();
+   mLoader->enqueue([this, sampleRate]() -> AssetLoader::Finalizer {
+      // create a SourceFile and set its output samplerate to match the Context.
+      // It is only opened here; the sound track is decoded while it plays.
+      audio::SourceFileRef soundTrackFile = audio::load(loadFile(L"sounds/soundtrack.mp3"), sampleRate);
+      return [this, soundTrackFile]() { setupSoundTrack(soundTrackFile); };
+   });
+}
+
+void TypingTutorApp::setupSoundTrack(const audio::SourceFileRef& soundTrackFile)
 {
    auto ctx = audio::Context::master();
 
-   // create a SourceFile and set its output samplerate to match the Context.
-   audio::SourceFileRef soundTrackFile = audio::load(loadFile(L"sounds/soundtrack.mp3"));
-   
-   // load the entire sound file into a BufferRef, and construct a BufferPlayerNode with this.
-   audio::BufferRef soundTrackBuffer = soundTrackFile->loadBuffer();
-   mSoundTrackPlayerNode = ctx->makeNode(new audio::BufferPlayerNode(soundTrackBuffer));
+   // stream the sound track through a small ring buffer, looping without gap
+   mSoundTrackPlayerNode = ctx->makeNode(new StreamPlayerNode(soundTrackFile));
    
    // add a Gain to reduce the volume
    mSoundTrackGain = ctx->makeNode(new audio::GainNode(0.2f));
@@ -116,138 +248,180 @@ void TypingTutorApp::setupSoundTrack()
    mSoundTrackPlayerNode >> mSoundTrackGain >> ctx->getOutput();
    ctx->enable();
    
-   mSoundTrackPlayerNode->setLoopEnabled();
-   mSoundTrackPlayerNode->start();
-}
-
-void TypingTutorApp::update()
-{
-   if (mAppStatePtr){ mAppStatePtr->update(this); }
+   mSoundTrackPlayerNode->enable();
 }
 
-void TypingTutorApp::draw()
+void TypingTutorApp::cleanup()
 {
-   hideCursor();
-
-   gl::clear(Color(0, 0, 0));
-   gl::enableAlphaBlending();
-
-   if (mPositionWindowOnceFlag) {
-      mPositionWindowOnceFlag = false;
-      setWindowSize(mBg->getSize());
-      const auto displayWidth = getWindow()->getDisplay()->getWidth();
-      const auto displayHeight = getWindow()->getDisplay()->getHeight();
-      const auto posX = (displayWidth - getWindowWidth()) / 2;
-      const auto posY = (displayHeight - getWindowHeight()) / 2;
-      setWindowPos(posX, posY);
+   // the screenshots in flight are written before the GL context goes away
+   if (mScreenCapture) {
+      mScreenCapture->flush();
+      mScreenCapture.reset();
    }
 
-   drawBg();
+   mRouter.reset();
+   mSeats.clear();
 
-   if (mAppStatePtr) { mAppStatePtr->draw(*this); }
+   if (mSoundTrackPlayerNode) {
+      CI_LOG_I(mSoundTrackPlayerNode->getReport());
+   }
 }
 
-void TypingTutorApp::drawBg()
+void TypingTutorApp::update()
 {
-   if (mBg) {
-      Rectf destRect = Rectf(mBg->getBounds()).getCenteredFit(getWindowBounds(), false);
+   mProfiler->beginFrame();
+   mLatency->update();
+   FrameProfiler::Scope scope(*mProfiler, FrameProfiler::Phase::Update);
 
-      const auto GameRunningNow = 
-         (mCurrentState == State::GamePosition ||
-          mCurrentState == State::GameHomeRow ||
-          mCurrentState == State::GameLetters ||
-          mCurrentState == State::GameNumbers);
+   mScreenCapture->update();
 
-      if (GameRunningNow) { 
-         gl::color(ColorA(1.0f, 1.0f, 1.0f, 0.7f)); 
+   // uploads of the decoded assets get a slice of the frame
+   if (mLoader) { 
+      FrameProfiler::Scope loaderScope(*mProfiler, FrameProfiler::Phase::Loader);
+      mLoader->update(0.004); 
+   }
+
+   {
+      FrameProfiler::Scope stateScope(*mProfiler, FrameProfiler::Phase::StateUpdate);
+      for (auto& rSeat : mSeats) {
+         if (rSeat) { rSeat->update(); }
       }
 
-      gl::draw(mBg, destRect);
+      // the simulations only touch their own game
+      mPool->run(static_cast<int>(mSeats.size()), [this](int seat) {
+         if (mSeats[seat]) { mSeats[seat]->advance(); }
+      });
 
-      if (GameRunningNow) { 
-         gl::color(Colorf(1.0f, 1.0f, 1.0f)); 
+      for (auto& rSeat : mSeats) {
+         if (rSeat) { rSeat->endUpdate(); }
       }
    }
+
+   closeQuittingSeats();
 }
 
-void TypingTutorApp::keyDown(KeyEvent event)
+void TypingTutorApp::closeQuittingSeats()
 {
-   const auto code = event.getCode();
-   if (mAppStatePtr) { mAppStatePtr->keyDown(code); }
+   auto nbOpenSeats = std::count_if(mSeats.begin(), mSeats.end(), [](const UniqueSeat& r){ return r != nullptr; });
+   for (auto& rSeat : mSeats) {
+      if (rSeat && rSeat->isQuitting()) {
+         if (nbOpenSeats == 1) {
+            quit();
+            return;
+         }
+         const auto window = rSeat->getWindow();
+         const auto closedFlag = rSeat->isWindowClosed();
+         rSeat.reset();
+         if (!closedFlag) { window->close(); }
+         --nbOpenSeats;
+      }
+   }
 }
 
-void TypingTutorApp::setState(State state)
+Seat* TypingTutorApp::findSeat(const WindowRef& window) const
 {
-   assert(state != State::Last);
-   mCurrentState = state;
-   
-   switch (state) {
-      case State::NewGame : resetGame()           ; break;
-      case State::Continue: setState(mCurrentGame); break;
-      case State::Quit    : quit()                ; break;
-      default:
-         const auto iState = static_cast<int>(mCurrentState);
-         mAppStatePtr = mAppStates[iState].get();
+   for (const auto& rSeat : mSeats) {
+      if (rSeat && rSeat->getWindow() == window) {
+         return rSeat.get();
+      }
    }
+   return nullptr;
 }
 
-void TypingTutorApp::resetGame()
+void TypingTutorApp::draw()
 {
-   if (mCurrentGame != State::Last) {
-      auto& rState = mAppStates[static_cast<int>(mCurrentGame)];
-      rState.reset(nullptr);
-   }
+   // called once per window, with the GL context of that window current
+   FrameProfiler::Scope scope(*mProfiler, FrameProfiler::Phase::Draw);
+   mLatency->draw();
 
-   switch (mSkill) {
-      case Skill::Positioning: mCurrentGame = State::GamePosition; break;
-      case Skill::HomeRow    : mCurrentGame = State::GameHomeRow ; break;
-      case Skill::Letters    : mCurrentGame = State::GameLetters ; break;
-      case Skill::Numbers    : mCurrentGame = State::GameNumbers ; break;
-   }
+   hideCursor();
 
-   auto& rState = mAppStates[static_cast<int>(mCurrentGame)];
+   gl::enableAlphaBlending();
 
-   switch (mCurrentGame) {
-      case State::GamePosition: rState.reset(new GamePositioning(mGameDuration)); break;
-      case State::GameHomeRow : rState.reset(new GameHomeRow    (mGameDuration)); break;
-      case State::GameLetters : rState.reset(new GameLetters    (mGameDuration)); break;
-      case State::GameNumbers : rState.reset(new GameNumbers    (mGameDuration)); break;
+   // the seat covers the whole window with its cached layer first
+   auto pSeat = findSeat(getWindow());
+   if (isLoadingMenu() || pSeat == nullptr) {
+      gl::clear(Color(0, 0, 0));
+      if (isLoadingMenu()) { drawProgress(); }
+      return;
    }
 
-   auto pGame = static_cast<Game*>(rState.get());
+   pSeat->draw();
 
-   setState(mCurrentGame);
+   if (mProfiler->isHudVisible() && getWindow() == getWindowIndex(0)) {
+      auto& rText = pSeat->getTextRenderer();
+      mProfiler->drawHud(rText, vec2(10, 40));
+      mLatency->drawHud(rText, vec2(10, 290));
+      rText.draw();
+   }
 }
 
-void TypingTutorApp::goBackToPreviousState()
+bool TypingTutorApp::isLoadingMenu() const
 {
-   if (mCurrentState == State::MenuApp) {
-      if ( isGameRunning() ) {
-         setState(mCurrentGame);
-      }
-   }
-   else {
-      setState(State::MenuApp);
-   }
+   // the menu shows up as soon as its background is uploaded
+   return (!mShared.background && mLoader && !mLoader->isDone());
 }
 
-void TypingTutorApp::setSkill(Skill skill)
+void TypingTutorApp::drawProgress()
 {
-   assert(skill != Skill::Last);
-   mSkill = skill;
+   const auto progress = mLoader ? mLoader->getProgress() : 0.0f;
+
+   auto rect = Rectf(0.0f, 0.0f, 0.5f * getWindowWidth(), 20.0f);
+   rect.offsetCenterTo(getWindowCenter());
+   gl::color(ColorA(1.0f, 1.0f, 1.0f, 0.4f));
+   gl::drawStrokedRect(rect);
+
+   rect.inflate(vec2(-2, -2));
+   rect.x2 = rect.x1 + progress * rect.getWidth();
+   gl::color(Colorf(75.0f / 255.0f, 170.0f / 255.0f, 66.0f / 255.0f));
+   gl::drawSolidRect(rect);
+
+   gl::color(Colorf(1.0f, 1.0f, 1.0f));
 }
 
-void TypingTutorApp::setGameDuration(double seconds)
+void TypingTutorApp::keyDown(KeyEvent event)
 {
-   mGameDuration = seconds;
+   if (mRouter && mRouter->isActive()) {
+      return; // the keys come from the router, keyboard by keyboard
+   }
+
+   handleKey(findSeat(event.getWindow()), event.getCode());
 }
 
-bool TypingTutorApp::isGameRunning()
+void TypingTutorApp::handleKey(Seat* pSeat, int code)
 {
- return (mCurrentGame == State::GamePosition ||
-         mCurrentGame == State::GameHomeRow  || 
-         mCurrentGame == State::GameLetters  ||
-         mCurrentGame == State::GameNumbers);
+   if (isLoadingMenu()) {
+      return; // still on the progress screen
+   }
+
+   // the profiler keys work everywhere and never reach the game
+   if (code == KeyEvent::KEY_F2) {
+      mProfiler->toggleHud();
+   }
+   else if (code == KeyEvent::KEY_F3) {
+      dumpProfile();
+   }
+   else if (pSeat) { 
+      // only the keys that reach a game or a menu are timed
+      mLatency->keyDown();
+      pSeat->keyDown(code); 
+   }
+}
+
+void TypingTutorApp::dumpProfile()
+{
+   try {
+      fs::create_directories("profiles");
+      const auto path = findFreePath("profiles/frames", ".csv");
+      mProfiler->dump(path);
+      CI_LOG_I("frame times written to " << path);
+      const auto latencyPath = findFreePath("profiles/latency", ".csv");
+      mLatency->dump(latencyPath);
+      CI_LOG_I("key latency histograms written to " << latencyPath);
+   }
+   catch (std::exception& exc) {
+      CI_LOG_EXCEPTION("failed to write the profiles.", exc);
+   }
 }
 
 CINDER_APP(TypingTutorApp, RendererGl, [](App::Settings *settings) {
@@ -0,0 +1,166 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "VoiceMixerNode.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define TT_MIXER_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace ci;
+
+namespace {
+
+   // dst[i] += gain * src[i], four samples at a time
+   void mulAdd(const float* src, float gain, float* dst, size_t length)
+   {
+      size_t i = 0;
+#ifdef TT_MIXER_SSE
+      const auto g = _mm_set1_ps(gain);
+      for (; i + 4 <= length; i += 4) {
+         const auto s = _mm_loadu_ps(src + i);
+         const auto d = _mm_loadu_ps(dst + i);
+         _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+      }
+#endif
+      for (; i < length; ++i) {
+         dst[i] += gain * src[i];
+      }
+   }
+}
+
+VoiceMixerNode::VoiceMixerNode(int nbVoices, int maxNbSounds) :
+InputNode(Format().channels(2)),
+mVoices(nbVoices),
+mCommands(4 * nbVoices)
+{
+   // the sounds never move once added; the audio thread reads them without locking
+   mSounds.resize(maxNbSounds);
+}
+
+int VoiceMixerNode::addSound(const audio::BufferRef& buffer, float gain, int priority)
+{
+   const auto sound = mNbSounds.load();
+   assert(sound < static_cast<int>(mSounds.size()));
+   assert(buffer);
+
+   mSounds[sound].reset(new Sound);
+   mSounds[sound]->buffer = buffer;
+   mSounds[sound]->gain = gain;
+   mSounds[sound]->priority = priority;
+
+   // published only now, after the sound is complete
+   mNbSounds = sound + 1;
+   return sound;
+}
+
+void VoiceMixerNode::setGain(int sound, float gain)
+{
+   assert(0 <= sound && sound < mNbSounds);
+   mSounds[sound]->gain = gain;
+}
+
+void VoiceMixerNode::play(int sound)
+{
+   assert(0 <= sound && sound < mNbSounds);
+
+   // picked up by the audio thread at its next block; dropped if the queue is full
+   mCommands.write(&sound, 1);
+}
+
+VoiceMixerNode::Voice* VoiceMixerNode::findVoice(int priority)
+{
+   Voice* pVictim = nullptr;
+   for (auto& rVoice : mVoices) {
+      if (rVoice.sound < 0) {
+         return &rVoice;
+      }
+
+      const auto voicePriority = mSounds[rVoice.sound]->priority;
+      if (voicePriority > priority) {
+         continue; // never steal a more important voice
+      }
+
+      if (pVictim == nullptr) {
+         pVictim = &rVoice;
+      }
+      else {
+         const auto victimPriority = mSounds[pVictim->sound]->priority;
+         if (voicePriority < victimPriority ||
+            (voicePriority == victimPriority && rVoice.startTick < pVictim->startTick)) {
+            pVictim = &rVoice;
+         }
+      }
+   }
+   return pVictim;
+}
+
+void VoiceMixerNode::mixVoice(Voice* pVoice, audio::Buffer* buffer)
+{
+   const auto& rSound = *mSounds[pVoice->sound];
+   const auto& rSource = *rSound.buffer;
+   const auto gain = rSound.gain.load();
+
+   const auto nbFrames = std::min(buffer->getNumFrames(), rSource.getNumFrames() - pVoice->pos);
+   const auto nbSourceChannels = rSource.getNumChannels();
+
+   // a mono effect goes to both channels
+   for (size_t ch = 0; ch < buffer->getNumChannels(); ++ch) {
+      const auto src = rSource.getChannel(std::min(ch, nbSourceChannels - 1)) + pVoice->pos;
+      mulAdd(src, gain, buffer->getChannel(ch), nbFrames);
+   }
+
+   pVoice->pos += nbFrames;
+   if (pVoice->pos >= rSource.getNumFrames()) {
+      pVoice->sound = -1;
+   }
+}
+
+void VoiceMixerNode::process(audio::Buffer* buffer)
+{
+   buffer->zero();
+
+   int sound = -1;
+   while (mCommands.read(&sound, 1)) {
+      auto pVoice = findVoice(mSounds[sound]->priority);
+      if (pVoice != nullptr) {
+         pVoice->sound = sound;
+         pVoice->pos = 0;
+         pVoice->startTick = ++mTick;
+      }
+   }
+
+   auto nbActiveVoices = 0;
+   for (auto& rVoice : mVoices) {
+      if (rVoice.sound >= 0) {
+         mixVoice(&rVoice, buffer);
+         ++nbActiveVoices;
+      }
+   }
+   mNbActiveVoices = nbActiveVoices;
+}
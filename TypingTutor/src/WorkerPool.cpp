@@ -0,0 +1,102 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int nbThreads)
+{
+   for (auto i = 0; i < nbThreads; ++i) {
+      mThreads.emplace_back(&WorkerPool::work, this);
+   }
+}
+
+WorkerPool::~WorkerPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStopFlag = true;
+   }
+   mWorkCondition.notify_all();
+
+   for (auto& rThread : mThreads) {
+      rThread.join();
+   }
+}
+
+void WorkerPool::run(int nbTasks, const Task& task)
+{
+   if (mThreads.empty() || nbTasks <= 1) {
+      for (auto i = 0; i < nbTasks; ++i) {
+         task(i);
+      }
+      return;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mTaskPtr = &task;
+      mNbTasks = nbTasks;
+      mNextTask = 0;
+      mNbBusy = getNbThreads();
+      ++mGeneration;
+   }
+   mWorkCondition.notify_all();
+
+   runTasks();
+
+   std::unique_lock<std::mutex> lock(mMutex);
+   mDoneCondition.wait(lock, [this]{ return mNbBusy == 0; });
+   mTaskPtr = nullptr;
+}
+
+void WorkerPool::work()
+{
+   auto generation = uint64_t(0);
+   while (true) {
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+         mWorkCondition.wait(lock, [this, generation]{ return mStopFlag || mGeneration != generation; });
+         if (mStopFlag) {
+            return;
+         }
+         generation = mGeneration;
+      }
+
+      runTasks();
+
+      {
+         std::lock_guard<std::mutex> lock(mMutex);
+         --mNbBusy;
+      }
+      mDoneCondition.notify_one();
+   }
+}
+
+void WorkerPool::runTasks()
+{
+   for (auto i = mNextTask++; i < mNbTasks; i = mNextTask++) {
+      (*mTaskPtr)(i);
+   }
+}
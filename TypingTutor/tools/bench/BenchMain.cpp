@@ -0,0 +1,301 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameCore.h"
+#include "GameRules.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Times the hot paths of the game simulation and prints the results as JSON,
+// to be kept along with each release and compared with the next one.
+//    tt_bench [--out=file]
+// Each case runs at a realistic size (the toons and keys of a real game) and
+// at a stress size (hundreds of toons, the full keyboard). A game holds at
+// most one toon per key and spawns them at the pace of its rules, so the
+// stress game is as busy as the rules allow; its hundreds of toons are also
+// stepped through a ToonPool of their own. A case is timed in batches of at
+// least 10 ms; the median and the best of 7 batches are kept.
+
+namespace {
+   struct Result {
+      std::string name;
+      std::string size;
+      long long iterations;
+      double nsPerOp;
+      double minNsPerOp;
+   };
+
+   using VResult = std::vector<Result>;
+
+   using Clock = std::chrono::steady_clock;
+
+   volatile int64_t sink = 0; // keeps the work from being optimized away
+
+   double getNsSince(Clock::time_point start)
+   {
+      return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+   }
+
+   // time(n) runs n passes of nbOpsPerPass operations and returns their ns
+   template<typename T>
+   Result measurePasses(const std::string& name, const std::string& size, int nbOpsPerPass, T time)
+   {
+      auto n = 1LL;
+      while (time(n) < 1.0e7 && n < (1LL << 40)) {
+         n *= 2;
+      }
+
+      const auto nbOps = n * nbOpsPerPass;
+      std::vector<double> samples;
+      for (auto i = 0; i < 7; ++i) {
+         samples.push_back(time(n) / nbOps);
+      }
+      std::sort(samples.begin(), samples.end());
+
+      return Result{ name, size, nbOps, samples[samples.size() / 2], samples.front() };
+   }
+
+   template<typename F>
+   Result measure(const std::string& name, const std::string& size, F f)
+   {
+      return measurePasses(name, size, 1, [&f](long long n) {
+         const auto start = Clock::now();
+         for (auto i = 0LL; i < n; ++i) { f(); }
+         return getNsSince(start);
+      });
+   }
+
+   std::string toJson(const VResult& results)
+   {
+      std::ostringstream ss;
+      ss << "{\n"
+#ifdef NDEBUG
+         << "  \"build\": \"release\",\n"
+#else
+         << "  \"build\": \"debug\",\n"
+#endif
+         << "  \"benchmarks\": [\n";
+      for (size_t i = 0; i < results.size(); ++i) {
+         const auto& r = results[i];
+         ss << "    { \"name\": \"" << r.name << "\", \"size\": \"" << r.size
+            << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.nsPerOp
+            << ", \"min_ns_per_op\": " << r.minNsPerOp << " }"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+      }
+      ss << "  ]\n}\n";
+      return ss.str();
+   }
+}
+
+// Sets up games of a given size and times their parts.
+class GameCoreBench {
+   public:
+      struct Size {
+         std::string name;
+         Skill skill;
+         int nbToons;
+         int maxNbToons;
+         int nbStreakBonuses;
+      };
+
+      static void run(const Size& size, VResult* pResults);
+
+   private:
+      static std::unique_ptr<GameCore> makeGame(const Size& size);
+      static void runToonPool(const Size& size, const GameCore& core, VResult* pResults);
+};
+
+std::unique_ptr<GameCore> GameCoreBench::makeGame(const Size& size)
+{
+   auto rules = GameRules::forSkill(size.skill, 1.0e9, false);
+   rules.maxNbToons = size.maxNbToons;
+
+   std::unique_ptr<GameCore> pCore(new GameCore(rules, KeyboardLayout::qwerty(), 1));
+   for (auto i = 0; i < size.nbToons; ++i) {
+      pCore->addToon(ci::vec2(120.0f, 120.0f));
+   }
+
+   // play until the keyboard is as busy as the rules allow
+   for (auto i = 0; i < 60 * 120; ++i) {
+      pCore->step();
+   }
+
+   return pCore;
+}
+
+void GameCoreBench::run(const Size& size, VResult* pResults)
+{
+   auto pCore = makeGame(size);
+   auto& rCore = *pCore;
+   auto& rKb = rCore.getKeyboard();
+   ci::Rand rand(1);
+
+   pResults->push_back(measure("GameCore::step", size.name, [&]() {
+      rCore.step();
+   }));
+
+   pResults->push_back(measure("KeyboardModel::randSelectKey", size.name, [&]() {
+      sink += rKb.randSelectKey(rand);
+   }));
+
+   // the same draws from the weights of an adaptive game
+   rKb.setWeighted(true);
+   pResults->push_back(measure("KeyboardModel::randSelectKey weighted", size.name, [&]() {
+      sink += rKb.randSelectKey(rand);
+   }));
+   auto weight = 1.0;
+   pResults->push_back(measure("KeyboardModel::setKeyWeight", size.name, [&]() {
+      weight = (weight < 4.0) ? weight + 0.25 : 1.0;
+      rKb.setKeyWeight(rKb.getKeys().front().code, weight);
+   }));
+   rKb.setWeighted(false);
+
+   // the keys with a toon in game, at the busiest step of the next minute:
+   // the hit path. A hit hurls the toon, so each pass presses them on a fresh
+   // copy of that step, left out of the time
+   auto busiestCore = rCore;
+   std::vector<int> heldCodes;
+   for (auto i = 0; i < 60 * 60; ++i) {
+      rCore.step();
+      std::vector<int> codes;
+      for (const auto& rPair : rCore.getKeyToonPairs()) {
+         if (rCore.getToons().isInGame(rPair.second)) {
+            codes.push_back(rPair.first);
+         }
+      }
+      if (codes.size() > heldCodes.size()) {
+         busiestCore = rCore;
+         heldCodes = codes;
+      }
+   }
+   if (!heldCodes.empty()) {
+      const auto nbHeld = static_cast<int>(heldCodes.size());
+      pResults->push_back(measurePasses("GameCore::keyDown hit", size.name, nbHeld, [&](long long n) {
+         auto ns = 0.0;
+         for (auto i = 0LL; i < n; ++i) {
+            auto core = busiestCore;
+            const auto start = Clock::now();
+            for (const auto code : heldCodes) {
+               core.keyDown(code);
+            }
+            ns += getNsSince(start);
+         }
+         return ns;
+      }));
+   }
+
+   // a key without a toon: the slot lookup and the wrong key path
+   pResults->push_back(measure("GameCore::keyDown miss", size.name, [&]() {
+      rCore.keyDown(KeyboardModel::KEY_UNKNOWN);
+   }));
+
+   std::vector<int> keyCodes;
+   for (const auto& rKey : rKb.getKeys()) {
+      keyCodes.push_back(rKey.code);
+   }
+   size_t iKey = 0;
+   pResults->push_back(measure("KeyboardModel::getKeyRectf", size.name, [&]() {
+      sink += static_cast<int64_t>(rKb.getKeyRectf(keyCodes[iKey]).x1);
+      iKey = (iKey + 1) % keyCodes.size();
+   }));
+
+   // the bonuses outlive the benchmark; every pass scans them all
+   GameCore::VStreakBonus bonuses(size.nbStreakBonuses, GameCore::StreakBonus{ "+10", ci::vec2(0.0f, 0.0f), 1.0e10 });
+   pResults->push_back(measure("GameCore::pruneStreakBonuses", size.name, [&]() {
+      GameCore::pruneStreakBonuses(&bonuses, rCore.getTime());
+   }));
+
+   runToonPool(size, rCore, pResults);
+}
+
+void GameCoreBench::runToonPool(const Size& size, const GameCore& core, VResult* pResults)
+{
+   // every toon of the size in game at once, each above a key of the keyboard
+   const auto& rKb = core.getKeyboard();
+   ToonPool toons(core.getRules().gameSpeedCoef);
+   std::vector<ci::Rectf> keyRects;
+   ci::Rand rand(1);
+   for (auto i = 0; i < size.nbToons; ++i) {
+      toons.add(ci::vec2(120.0f, 120.0f));
+      keyRects.push_back(rKb.getSlotRectf(i % rKb.getNbSlots()));
+   }
+
+   // one step of the pool; the toons retired are spawned again right away,
+   // drawn from the free list as a game does
+   pResults->push_back(measure("ToonPool::update", size.name, [&]() {
+      while (toons.getNbAvailable() > 0) {
+         toons.spawnAvailable(rand.nextInt(toons.getNbAvailable()));
+      }
+      for (auto toon = 0; toon < toons.getSize(); ++toon) {
+         sink += toons.update(toon, GameCore::TIME_STEP, keyRects[toon], core.getBounds(), rand);
+      }
+   }));
+}
+
+int main(int argc, char* argv[])
+{
+   std::string outPath;
+   for (auto i = 1; i < argc; ++i) {
+      const std::string arg(argv[i]);
+      if (arg.compare(0, 6, "--out=") == 0) {
+         outPath = arg.substr(6);
+      }
+      else {
+         std::cerr << "usage: tt_bench [--out=file]" << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+
+   const GameCoreBench::Size sizes[] = {
+      { "realistic", Skill::Letters, 10,  3,    2 },
+      { "stress",    Skill::Numbers, 500, 500, 1000 },
+   };
+
+   VResult results;
+   for (const auto& size : sizes) {
+      GameCoreBench::run(size, &results);
+   }
+
+   const auto json = toJson(results);
+   if (outPath.empty()) {
+      std::cout << json;
+   }
+   else {
+      std::ofstream ofs(outPath);
+      ofs << json;
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,254 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "BotTypist.h"
+#include "GameCore.h"
+#include "GameRules.h"
+#include "KeyboardLayout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Plays many games of each skill with simulated typists, on every core and as
+// fast as they go, then prints the spread of the scores, of the longest
+// streaks and of the share of toons that escaped.
+//    tt_bot [--sessions=1000] [--duration=180] [--wpm=40] [--reaction=0.45]
+//           [--reaction-sd=0.15] [--errors=0.03] [--toons=8] [--csv=file]
+//           [--layout=file] [--adaptive=1]
+// The sessions are seeded from their number, so two runs with the same
+// arguments give the same results.
+
+namespace {
+   struct Options {
+      int nbSessions{ 1000 };
+      double duration{ 180.0 };
+      int nbToons{ 8 };
+      ci::vec2 toonSize{ 120.0f, 120.0f };
+      BotTypist::Profile profile;
+      KeyboardLayout layout{ KeyboardLayout::qwerty() };
+      bool adaptiveFlag{ false };
+      std::string csvPath;
+   };
+
+   struct SessionResult {
+      double score{ 0.0 };
+      int longestStreak{ 0 };
+      int spawned{ 0 };
+      int escaped{ 0 };
+   };
+
+   using VSessionResult = std::vector<SessionResult>;
+
+   class Tally : public GameObserver {
+      public:
+         Tally(SessionResult* pResult) : mResultPtr(pResult) {}
+
+         virtual void onToonSpawned(int /*keyCode*/) override { ++mResultPtr->spawned; }
+         virtual void onToonHurled(int /*keyCode*/, double /*score*/) override
+         {
+            mResultPtr->longestStreak = std::max(++mStreak, mResultPtr->longestStreak);
+         }
+         virtual void onToonEscaped(int /*keyCode*/) override { ++mResultPtr->escaped; mStreak = 0; }
+         virtual void onWrongKey(int /*keyCode*/) override { mStreak = 0; }
+
+      private:
+         SessionResult* mResultPtr{ nullptr };
+         int mStreak{ 0 };
+   };
+
+   SessionResult playSession(Skill skill, const Options& options, uint32_t seed)
+   {
+      SessionResult result;
+
+      GameCore core(GameRules::forSkill(skill, options.duration, options.adaptiveFlag), options.layout, seed);
+      for (auto i = 0; i < options.nbToons; ++i) {
+         core.addToon(options.toonSize);
+      }
+
+      Tally tally(&result);
+      core.addObserver(&tally);
+      BotTypist bot(&core, options.profile, ~seed);
+
+      while (core.getState() != GameCore::State::GameOver) {
+         bot.update();
+         core.step();
+      }
+
+      result.score = core.getScore();
+      return result;
+   }
+
+   VSessionResult playSessions(Skill skill, const Options& options)
+   {
+      VSessionResult results(options.nbSessions);
+      std::atomic<int> nextSession{ 0 };
+
+      auto worker = [&]() {
+         for (auto i = nextSession++; i < options.nbSessions; i = nextSession++) {
+            const auto seed = static_cast<uint32_t>(i) * 4 + static_cast<uint32_t>(skill);
+            results[i] = playSession(skill, options, seed);
+         }
+      };
+
+      const auto nbThreads = std::max(1u, std::thread::hardware_concurrency());
+      std::vector<std::thread> threads;
+      for (auto i = 0u; i < nbThreads; ++i) {
+         threads.emplace_back(worker);
+      }
+      for (auto& rThread : threads) {
+         rThread.join();
+      }
+
+      return results;
+   }
+
+   std::string summarize(std::vector<double> values)
+   {
+      std::sort(values.begin(), values.end());
+      const auto at = [&values](double q) { return values[static_cast<size_t>(q * (values.size() - 1))]; };
+      const auto mean = std::accumulate(values.cbegin(), values.cend(), 0.0) / values.size();
+
+      std::ostringstream ss;
+      ss << std::fixed << std::setprecision(2)
+         << std::setw(10) << mean
+         << std::setw(10) << at(0.0)
+         << std::setw(10) << at(0.1)
+         << std::setw(10) << at(0.5)
+         << std::setw(10) << at(0.9)
+         << std::setw(10) << at(1.0);
+      return ss.str();
+   }
+
+   const char* getSkillName(Skill skill)
+   {
+      switch (skill) {
+         case Skill::Positioning: return "positioning";
+         case Skill::HomeRow    : return "home row";
+         case Skill::Letters    : return "letters";
+         case Skill::Numbers    : return "numbers";
+         default                : return "?";
+      }
+   }
+
+   bool parseOption(const std::string& arg, Options* pOptions)
+   {
+      const auto pos = arg.find('=');
+      if (arg.compare(0, 2, "--") != 0 || pos == std::string::npos) {
+         return false;
+      }
+
+      const auto name = arg.substr(2, pos - 2);
+      const auto value = arg.substr(pos + 1);
+      auto& rProfile = pOptions->profile;
+
+      if      (name == "sessions"   ) { pOptions->nbSessions = std::atoi(value.c_str()); }
+      else if (name == "duration"   ) { pOptions->duration = std::atof(value.c_str()); }
+      else if (name == "toons"      ) { pOptions->nbToons = std::atoi(value.c_str()); }
+      else if (name == "wpm"        ) { rProfile.wpm = std::atof(value.c_str()); }
+      else if (name == "reaction"   ) { rProfile.reactionTime = std::atof(value.c_str()); }
+      else if (name == "reaction-sd") { rProfile.reactionTimeSd = std::atof(value.c_str()); }
+      else if (name == "errors"     ) { rProfile.errorRate = std::atof(value.c_str()); }
+      else if (name == "csv"        ) { pOptions->csvPath = value; }
+      else if (name == "layout"     ) { pOptions->layout = KeyboardLayout::load(value); }
+      else if (name == "adaptive"   ) { pOptions->adaptiveFlag = (std::atoi(value.c_str()) != 0); }
+      else { return false; }
+
+      return true;
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   Options options;
+   try {
+      for (auto i = 1; i < argc; ++i) {
+         if (!parseOption(argv[i], &options)) {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+         }
+      }
+   }
+   catch (std::exception& exc) {
+      std::cerr << exc.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   if (options.nbSessions < 1 || options.profile.wpm <= 0.0 || options.profile.reactionTime <= 0.0) {
+      std::cerr << "sessions, wpm and reaction must be positive" << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   std::ofstream csv;
+   if (!options.csvPath.empty()) {
+      csv.open(options.csvPath);
+      csv << "skill,session,score,longest_streak,spawned,escaped\n";
+   }
+
+   std::cout << options.layout.name << ", " << options.nbSessions << " sessions of " << options.duration << " s per skill, "
+             << options.profile.wpm << " wpm, reaction " << options.profile.reactionTime
+             << " +/- " << options.profile.reactionTimeSd << " s, "
+             << 100.0 * options.profile.errorRate << "% errors" << (options.adaptiveFlag ? ", adaptive" : "") << "\n\n"
+             << std::setw(28) << "mean" << std::setw(10) << "min" << std::setw(10) << "p10"
+             << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "max" << "\n";
+
+   for (auto iSkill = 0; iSkill < static_cast<int>(Skill::Last); ++iSkill) {
+      const auto skill = static_cast<Skill>(iSkill);
+      const auto results = playSessions(skill, options);
+
+      std::vector<double> scores;
+      std::vector<double> streaks;
+      std::vector<double> escapeRates;
+      for (const auto& r : results) {
+         scores.push_back(r.score);
+         streaks.push_back(r.longestStreak);
+         escapeRates.push_back(r.spawned > 0 ? 100.0 * r.escaped / r.spawned : 0.0);
+      }
+
+      std::cout << getSkillName(skill) << "\n"
+                << "   score          " << summarize(scores) << "\n"
+                << "   longest streak " << summarize(streaks) << "\n"
+                << "   escaped (%)    " << summarize(escapeRates) << "\n";
+
+      if (csv.is_open()) {
+         for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            csv << getSkillName(skill) << "," << i << "," << r.score << "," << r.longestStreak
+                << "," << r.spawned << "," << r.escaped << "\n";
+         }
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "BotTypist.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+BotTypist::BotTypist(GameCore* pCore, const Profile& profile, uint32_t seed) :
+mCorePtr(pCore),
+mProfile(profile),
+mRand(seed)
+{
+   assert(mCorePtr != nullptr);
+   assert(mProfile.reactionTime > 0.0 && mProfile.wpm > 0.0);
+
+   // the log-normal parameters that give the profile's mean and deviation
+   const auto ratio = mProfile.reactionTimeSd / mProfile.reactionTime;
+   const auto sigma2 = std::log(1.0 + ratio * ratio);
+   const auto mu = std::log(mProfile.reactionTime) - 0.5 * sigma2;
+   mReactionTime = std::lognormal_distribution<double>(mu, std::sqrt(sigma2));
+
+   mKeyInterval = 60.0 / (5.0 * mProfile.wpm);
+
+   mCorePtr->addObserver(this);
+}
+
+double BotTypist::getTime() const
+{
+   // the core's own clock restarts when the game starts; the step count does not
+   return mCorePtr->getStepCount() * GameCore::TIME_STEP;
+}
+
+void BotTypist::update()
+{
+   const auto time = getTime();
+   if (time < mNextKeyTime || mTargets.empty()) {
+      return;
+   }
+
+   const auto it = std::min_element(mTargets.begin(), mTargets.end(),
+      [](const Target& a, const Target& b){ return a.time < b.time; });
+   if (it->time > time) {
+      return;
+   }
+
+   mNextKeyTime = time + mKeyInterval;
+
+   if (mUniform(mRand) < mProfile.errorRate) {
+      // a typo; the right key still comes after it
+      mCorePtr->keyDown(findNeighbourKey(it->keyCode));
+      return;
+   }
+
+   const auto keyCode = it->keyCode;
+   mTargets.erase(it);
+   mCorePtr->keyDown(keyCode);
+}
+
+int BotTypist::findNeighbourKey(int keyCode)
+{
+   const auto& rKb = mCorePtr->getKeyboard();
+   const auto& rKey = rKb.getKey(keyCode);
+   const auto col = (mUniform(mRand) < 0.5) ? rKey.col - 1 : rKey.col + 1;
+
+   for (const auto& i : rKb.getKeys()) {
+      if (i.row == rKey.row && i.col == col) {
+         return i.code;
+      }
+   }
+   return KeyboardModel::KEY_UNKNOWN; // off the edge of the keyboard
+}
+
+void BotTypist::onToonSpawned(int keyCode)
+{
+   mTargets.push_back({ keyCode, getTime() + mReactionTime(mRand) });
+}
+
+void BotTypist::onToonHurled(int keyCode, double /*score*/)
+{
+   // a typo can hurl the toon of the key it lands on; that target is done
+   dropTargets(keyCode);
+}
+
+void BotTypist::onToonEscaped(int keyCode)
+{
+   dropTargets(keyCode);
+}
+
+void BotTypist::dropTargets(int keyCode)
+{
+   mTargets.erase(
+      std::remove_if(
+         mTargets.begin(),
+         mTargets.end(),
+         [keyCode](const Target& r){ return r.keyCode == keyCode; }),
+      mTargets.end());
+}
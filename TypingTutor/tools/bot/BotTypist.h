@@ -0,0 +1,75 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "GameCore.h"
+#include "GameObserver.h"
+
+#include <random>
+#include <vector>
+
+// A simulated typist. It sees each toon when it spawns, reacts after a delay
+// drawn from a log-normal distribution, types no faster than its words per
+// minute allow and now and then hits a key next to the right one. It plays
+// through GameCore::keyDown, the path the real keyboard takes.
+class BotTypist : public GameObserver {
+   public:
+      struct Profile {
+         double reactionTime{ 0.45 };    // mean, in seconds
+         double reactionTimeSd{ 0.15 };
+         double wpm{ 40.0 };              // five keys per word
+         double errorRate{ 0.03 };
+      };
+
+      BotTypist(GameCore* pCore, const Profile& profile, uint32_t seed);
+
+      void update();
+
+      virtual void onToonSpawned(int keyCode) override;
+      virtual void onToonHurled(int keyCode, double score) override;
+      virtual void onToonEscaped(int keyCode) override;
+
+   private:
+      struct Target {
+         int keyCode;
+         double time;
+      };
+
+      using VTarget = std::vector<Target>;
+
+      double getTime() const;
+      int findNeighbourKey(int keyCode);
+      void dropTargets(int keyCode);
+
+      GameCore* mCorePtr{ nullptr };
+      Profile mProfile;
+      std::mt19937 mRand;
+      std::lognormal_distribution<double> mReactionTime;
+      std::uniform_real_distribution<double> mUniform;
+      double mKeyInterval{ 0.0 };
+      double mNextKeyTime{ 0.0 };
+      VTarget mTargets;
+};
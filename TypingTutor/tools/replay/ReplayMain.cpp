@@ -0,0 +1,99 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "GameReplayer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Plays a game log of the replays folder again, without a window or sound,
+// and prints how it ended.
+//    tt_replay <log.ttr> [speed]
+// A speed of 2 plays twice as fast as the game was played; 0 (the default)
+// plays as fast as the machine allows.
+
+namespace {
+   class Tally : public GameObserver {
+      public:
+         virtual void onToonSpawned(int /*keyCode*/) override { ++spawned; }
+         virtual void onToonHurled(int /*keyCode*/, double /*score*/) override { ++hurled; }
+         virtual void onToonEscaped(int /*keyCode*/) override { ++escaped; }
+         virtual void onWrongKey(int /*keyCode*/) override { ++wrongKeys; }
+
+         int spawned{ 0 };
+         int hurled{ 0 };
+         int escaped{ 0 };
+         int wrongKeys{ 0 };
+   };
+}
+
+int main(int argc, char* argv[])
+{
+   if (argc < 2) {
+      std::cerr << "usage: tt_replay <log.ttr> [speed]" << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   const auto speed = (argc > 2) ? std::atof(argv[2]) : 0.0;
+
+   try {
+      GameReplayer replayer(GameLog::load(argv[1]));
+      Tally tally;
+      replayer.getCore().addObserver(&tally);
+
+      const auto start = std::chrono::steady_clock::now();
+      if (speed > 0.0) {
+         replayer.setSpeed(speed);
+         auto last = start;
+         while (!replayer.isDone()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            const auto now = std::chrono::steady_clock::now();
+            replayer.advance(std::chrono::duration<double>(now - last).count());
+            last = now;
+         }
+      }
+      else {
+         replayer.run();
+      }
+      const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      const auto& rCore = replayer.getCore();
+      std::cout << "layout:     " << rCore.getKeyboard().getLayout().name << (rCore.getRules().adaptiveFlag ? ", adaptive" : "") << "\n"
+                << "score:      " << static_cast<int>(rCore.getScore()) << (rCore.isPerfectGame() ? " (perfect game)" : "") << "\n"
+                << "streak:     " << rCore.getStreakCnt() << "/" << rCore.getStreakThreshold() << "\n"
+                << "toons:      " << tally.spawned << " spawned, " << tally.hurled << " hurled, " << tally.escaped << " escaped\n"
+                << "wrong keys: " << tally.wrongKeys << "\n"
+                << "steps:      " << rCore.getStepCount() << " in " << elapsed << " s" << std::endl;
+   }
+   catch (std::exception& exc) {
+      std::cerr << exc.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,479 @@
+/*
+Copyright(c) 2016, Dominique Rivard
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "KeyboardLayout.h"
+#include "KeyboardModel.h"
+#include "MappedFile.h"
+#include "SessionLog.h"
+#include "Skill.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// Reads the session logs of a class and prints the reaction times and the
+// accuracy of the games played in a date range, per skill, per finger column
+// and per key, slowest keys first.
+//    tt_stats [--from=2026-09-01] [--to=2026-09-30] [--skill=letters]
+//             [--layout=file] [--top=10] [--csv=file] log-or-folder...
+// A folder stands for the .tts files in it. Games played on a layout other
+// than --layout (QWERTY by default) are left out, since their keys sit on
+// other fingers; older logs, which do not name the layout, are counted. The
+// logs are mapped read-only, so they can be read while the game appends to
+// them, and cut in ranges of records shared out over every core; a range
+// takes the sessions that start in it. Each thread tallies into flat tables
+// of its own, which are added together at the end. Reaction times are kept
+// in 10 ms bins.
+
+namespace {
+   const int NB_BINS = 500;
+   const int RANGE_SIZE = 64 * 1024; // records, 1 MB
+   const double BIN_WIDTH = 0.01;
+   const int NB_SKILLS = static_cast<int>(Skill::Last);
+   const char* const SKILL_NAMES[] = { "positioning", "home_row", "letters", "numbers" };
+
+   struct Options {
+      int64_t from{ std::numeric_limits<int64_t>::min() };
+      int64_t to{ std::numeric_limits<int64_t>::max() };
+      int skill{ -1 };
+      int top{ 10 };
+      KeyboardLayout layout{ KeyboardLayout::qwerty() };
+      std::string csvPath;
+      std::vector<std::string> paths;
+   };
+
+   // one key, finger column or skill
+   struct Tally {
+      Tally() : bins(NB_BINS, 0) {}
+
+      void addHit(double reactionTime)
+      {
+         const auto bin = static_cast<int>(reactionTime / BIN_WIDTH);
+         ++bins[std::min(std::max(bin, 0), NB_BINS - 1)];
+         ++hits;
+      }
+
+      void add(const Tally& r)
+      {
+         hits += r.hits;
+         misses += r.misses;
+         escapes += r.escapes;
+         for (auto i = 0; i < NB_BINS; ++i) {
+            bins[i] += r.bins[i];
+         }
+      }
+
+      double getAccuracy() const
+      {
+         return (hits + misses > 0) ? 100.0 * hits / (hits + misses) : 0.0;
+      }
+
+      double getReactionTime(double q) const
+      {
+         const auto rank = static_cast<int>(q * hits);
+         auto count = 0;
+         for (auto i = 0; i < NB_BINS; ++i) {
+            count += bins[i];
+            if (count > rank) {
+               return (i + 0.5) * BIN_WIDTH;
+            }
+         }
+         return 0.0;
+      }
+
+      int hits{ 0 };
+      int misses{ 0 };
+      int escapes{ 0 };
+      std::vector<int> bins;
+   };
+
+   struct Tables {
+      Tables() : keys(KeyboardModel::NB_KEY_CODES), skills(NB_SKILLS), games(NB_SKILLS, 0),
+         finished(NB_SKILLS, 0), scores(NB_SKILLS, 0.0) {}
+
+      void add(const Tables& r)
+      {
+         otherLayouts += r.otherLayouts;
+         for (size_t i = 0; i < keys.size(); ++i) { keys[i].add(r.keys[i]); }
+         for (auto i = 0; i < NB_SKILLS; ++i) {
+            skills[i].add(r.skills[i]);
+            games[i] += r.games[i];
+            finished[i] += r.finished[i];
+            scores[i] += r.scores[i];
+         }
+      }
+
+      std::vector<Tally> keys; // by key code
+      std::vector<Tally> skills;
+      std::vector<int> games;
+      std::vector<int> finished;
+      std::vector<double> scores;
+      int otherLayouts{ 0 }; // games left out
+   };
+
+   // a run of records of one log; the sessions that start in it are its own
+   struct Range {
+      const SessionRecord* pRecords;
+      int nbRecords; // in the whole log
+      int begin;
+      int end;
+   };
+
+   void scanRange(const Range& range, const Options& options, Tables* pTables)
+   {
+      const auto pRecords = range.pRecords;
+
+      // the session under way where the range begins is the previous range's
+      auto i = range.begin;
+      while (i < range.nbRecords && SessionLog::isValid(pRecords[i]) && pRecords[i].type != SessionRecord::Start) {
+         ++i;
+      }
+
+      // the events of the session in range, if the last one started is
+      auto session = std::numeric_limits<uint32_t>::max();
+      auto skill = -1;
+      std::string layoutName;
+      for (; i < range.nbRecords; ++i) {
+         const auto& r = pRecords[i];
+         if (!SessionLog::isValid(r)) {
+            break; // the end of the log
+         }
+
+         if (r.type == SessionRecord::Start) {
+            if (i >= range.end) {
+               break; // the next range's session
+            }
+            const auto inRangeFlag = (options.from <= r.step && r.step < options.to &&
+               r.code < NB_SKILLS && (options.skill < 0 || options.skill == r.code));
+            session = r.session;
+            skill = inRangeFlag ? r.code : -1;
+            layoutName.clear();
+            if (inRangeFlag) { ++pTables->games[skill]; }
+            continue;
+         }
+         if (r.session != session || skill < 0) {
+            continue;
+         }
+
+         if (r.type == SessionRecord::Layout) {
+            char piece[8];
+            std::memcpy(piece, &r.step, 4);
+            std::memcpy(piece + 4, &r.value, 4);
+            layoutName.append(piece, std::find(piece, piece + 8, '\0'));
+            if ((r.code & SessionRecord::LAST_PIECE) != 0 && layoutName != options.layout.name) {
+               --pTables->games[skill];
+               ++pTables->otherLayouts;
+               skill = -1;
+            }
+            continue;
+         }
+
+         auto& rKey = pTables->keys[r.code % KeyboardModel::NB_KEY_CODES];
+         auto& rSkill = pTables->skills[skill];
+         switch (r.type) {
+            case SessionRecord::Hit   : rKey.addHit(r.value); rSkill.addHit(r.value); break;
+            case SessionRecord::Miss  : ++rKey.misses; ++rSkill.misses; break;
+            case SessionRecord::Escape: ++rKey.escapes; ++rSkill.escapes; break;
+            case SessionRecord::End   : ++pTables->finished[skill]; pTables->scores[skill] += r.value; break;
+            default: break;
+         }
+      }
+   }
+
+   Tables scanLogs(const Options& options)
+   {
+      // the logs are cut in ranges, so that a single large log keeps every
+      // core busy too
+      std::vector<std::unique_ptr<MappedFile>> files;
+      std::vector<Range> ranges;
+      for (const auto& path : options.paths) {
+         try {
+            std::unique_ptr<MappedFile> pFile(new MappedFile(path, MappedFile::Mode::ReadOnly));
+            auto nbRecords = 0;
+            const auto pRecords = SessionLog::getRecords(*pFile, &nbRecords);
+            for (auto begin = 0; begin < nbRecords; begin += RANGE_SIZE) {
+               ranges.push_back({ pRecords, nbRecords, begin, std::min(begin + RANGE_SIZE, nbRecords) });
+            }
+            files.push_back(std::move(pFile));
+         }
+         catch (std::exception& exc) {
+            std::cerr << path << ": " << exc.what() << std::endl;
+         }
+      }
+
+      const auto nbRanges = static_cast<int>(ranges.size());
+      const auto nbThreads = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()), nbRanges));
+      std::vector<Tables> threadTables(nbThreads);
+      std::atomic<int> nextRange{ 0 };
+
+      auto worker = [&](Tables* pTables) {
+         for (auto i = nextRange++; i < nbRanges; i = nextRange++) {
+            scanRange(ranges[i], options, pTables);
+         }
+      };
+
+      std::vector<std::thread> threads;
+      for (auto& rTables : threadTables) {
+         threads.emplace_back(worker, &rTables);
+      }
+      for (auto& rThread : threads) {
+         rThread.join();
+      }
+
+      for (auto i = 1; i < nbThreads; ++i) {
+         threadTables[0].add(threadTables[i]);
+      }
+      return std::move(threadTables[0]);
+   }
+
+   bool isFolder(const std::string& path)
+   {
+#ifdef _WIN32
+      const auto attributes = GetFileAttributesA(path.c_str());
+      return (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+#else
+      struct stat st;
+      return (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+#endif
+   }
+
+   void addLogs(const std::string& path, std::vector<std::string>* pPaths)
+   {
+      if (!isFolder(path)) {
+         pPaths->push_back(path);
+         return;
+      }
+
+      std::vector<std::string> names;
+#ifdef _WIN32
+      WIN32_FIND_DATAA data;
+      const auto handle = FindFirstFileA((path + "\\*.tts").c_str(), &data);
+      if (handle != INVALID_HANDLE_VALUE) {
+         do { names.push_back(data.cFileName); } while (FindNextFileA(handle, &data));
+         FindClose(handle);
+      }
+#else
+      if (auto pDir = opendir(path.c_str())) {
+         while (auto pEntry = readdir(pDir)) {
+            const std::string name(pEntry->d_name);
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tts") == 0) {
+               names.push_back(name);
+            }
+         }
+         closedir(pDir);
+      }
+#endif
+      std::sort(names.begin(), names.end());
+      for (const auto& name : names) {
+         pPaths->push_back(path + "/" + name);
+      }
+   }
+
+   // a local date, YYYY-MM-DD, in seconds since 1970
+   int64_t parseDate(const std::string& date)
+   {
+      std::tm tm = {};
+      if (std::sscanf(date.c_str(), "%d-%d-%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday) != 3) {
+         throw std::runtime_error("bad date " + date + ", expected YYYY-MM-DD");
+      }
+      tm.tm_year -= 1900;
+      tm.tm_mon -= 1;
+      tm.tm_isdst = -1;
+      return static_cast<int64_t>(std::mktime(&tm));
+   }
+
+   bool parseOption(const std::string& arg, Options* pOptions)
+   {
+      if (arg.compare(0, 2, "--") != 0) {
+         addLogs(arg, &pOptions->paths);
+         return true;
+      }
+
+      const auto pos = arg.find('=');
+      if (pos == std::string::npos) {
+         return false;
+      }
+
+      const auto name = arg.substr(2, pos - 2);
+      const auto value = arg.substr(pos + 1);
+
+      if      (name == "from"  ) { pOptions->from = parseDate(value); }
+      else if (name == "to"    ) { pOptions->to = parseDate(value) + 24 * 60 * 60; }
+      else if (name == "top"   ) { pOptions->top = std::atoi(value.c_str()); }
+      else if (name == "layout") { pOptions->layout = KeyboardLayout::load(value); }
+      else if (name == "csv"   ) { pOptions->csvPath = value; }
+      else if (name == "skill" ) {
+         const auto it = std::find(std::begin(SKILL_NAMES), std::end(SKILL_NAMES), value);
+         if (it == std::end(SKILL_NAMES)) {
+            throw std::runtime_error("unknown skill " + value);
+         }
+         pOptions->skill = static_cast<int>(it - std::begin(SKILL_NAMES));
+      }
+      else { return false; }
+
+      return true;
+   }
+
+   struct Row {
+      std::string name;
+      const Tally* pTally;
+   };
+
+   void printRows(const std::string& title, const std::vector<Row>& rows)
+   {
+      std::cout << "\n" << std::left << std::setw(16) << title << std::right
+                << std::setw(10) << "hits" << std::setw(10) << "misses" << std::setw(10) << "escapes"
+                << std::setw(12) << "accuracy %" << std::setw(10) << "p50 (s)" << std::setw(10) << "p90 (s)" << "\n"
+                << std::fixed << std::setprecision(2);
+      for (const auto& row : rows) {
+         const auto& r = *row.pTally;
+         std::cout << std::left << std::setw(16) << row.name << std::right
+                   << std::setw(10) << r.hits << std::setw(10) << r.misses << std::setw(10) << r.escapes
+                   << std::setw(12) << r.getAccuracy() << std::setw(10) << r.getReactionTime(0.5)
+                   << std::setw(10) << r.getReactionTime(0.9) << "\n";
+      }
+   }
+
+   void writeRows(std::ostream& csv, const std::string& table, const std::vector<Row>& rows)
+   {
+      for (const auto& row : rows) {
+         const auto& r = *row.pTally;
+         csv << table << "," << row.name << "," << r.hits << "," << r.misses << "," << r.escapes << ","
+             << r.getAccuracy() << "," << r.getReactionTime(0.5) << "," << r.getReactionTime(0.9) << "\n";
+      }
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   Options options;
+   try {
+      for (auto i = 1; i < argc; ++i) {
+         if (!parseOption(argv[i], &options)) {
+            std::cerr << "unknown option " << argv[i] << std::endl;
+            return EXIT_FAILURE;
+         }
+      }
+   }
+   catch (std::exception& exc) {
+      std::cerr << exc.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   if (options.paths.empty()) {
+      std::cerr << "usage: tt_stats [--from=YYYY-MM-DD] [--to=YYYY-MM-DD] [--skill=name] "
+                   "[--layout=file] [--top=10] [--csv=file] log-or-folder..." << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   const auto start = std::chrono::steady_clock::now();
+   auto tables = scanLogs(options);
+   const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+   const auto nbGames = std::accumulate(tables.games.cbegin(), tables.games.cend(), 0);
+   std::cout << options.paths.size() << " logs, " << nbGames << " games on " << options.layout.name
+             << ", read in " << elapsed << " s\n";
+   if (tables.otherLayouts > 0) {
+      std::cout << tables.otherLayouts << " games on other layouts left out\n";
+   }
+
+   // skills
+   std::cout << "\n" << std::left << std::setw(16) << "skill" << std::right
+             << std::setw(10) << "games" << std::setw(10) << "finished" << std::setw(12) << "mean score" << "\n";
+   std::vector<Row> skillRows;
+   for (auto i = 0; i < NB_SKILLS; ++i) {
+      const auto meanScore = (tables.finished[i] > 0) ? tables.scores[i] / tables.finished[i] : 0.0;
+      std::cout << std::left << std::setw(16) << SKILL_NAMES[i] << std::right
+                << std::setw(10) << tables.games[i] << std::setw(10) << tables.finished[i]
+                << std::setw(12) << std::fixed << std::setprecision(1) << meanScore << "\n";
+      skillRows.push_back({ SKILL_NAMES[i], &tables.skills[i] });
+   }
+   printRows("skill", skillRows);
+
+   // finger columns, from the keys of the layout
+   std::vector<Tally> cols;
+   std::vector<Row> keyRows;
+   for (const auto& rKey : options.layout.keys) {
+      if (rKey.col >= static_cast<int>(cols.size())) {
+         cols.resize(rKey.col + 1);
+      }
+      const auto& rTally = tables.keys[rKey.code];
+      cols[rKey.col].add(rTally);
+      if (rTally.hits + rTally.misses > 0) {
+         keyRows.push_back({ rKey.c, &rTally });
+      }
+   }
+   std::vector<Row> colRows;
+   for (size_t i = 0; i < cols.size(); ++i) {
+      colRows.push_back({ std::to_string(i), &cols[i] });
+   }
+   printRows("finger column", colRows);
+
+   // keys, slowest first
+   std::sort(keyRows.begin(), keyRows.end(), [](const Row& a, const Row& b) {
+      return a.pTally->getReactionTime(0.5) > b.pTally->getReactionTime(0.5);
+   });
+   const auto nbShown = (options.top > 0) ? std::min(keyRows.size(), static_cast<size_t>(options.top)) : keyRows.size();
+   printRows("key", std::vector<Row>(keyRows.begin(), keyRows.begin() + nbShown));
+
+   if (!options.csvPath.empty()) {
+      std::ofstream csv(options.csvPath);
+      csv << "table,name,hits,misses,escapes,accuracy,p50,p90\n";
+      writeRows(csv, "skill", skillRows);
+      writeRows(csv, "column", colRows);
+      writeRows(csv, "key", keyRows);
+      if (!csv) {
+         std::cerr << "cannot write " << options.csvPath << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+
+   return EXIT_SUCCESS;
+}